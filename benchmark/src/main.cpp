@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <webview/impl/v3/process_memory_linux_v3.hpp>
+#include <webview/webview.hpp>
+
+// Measures the bridge of the headless web view (and the memory / the open latency of the web views), the results are written as JSON (to stdout or to the given file):
+//	webview_bench [--quick] [output.json]
+// `--quick` runs every benchmark with much fewer samples (for CI).
+
+namespace
+{
+	using gal::web_view::WebView;
+	using gal::web_view::WebViewHost;
+	using gal::web_view::WebViewPool;
+	using clock_type = std::chrono::steady_clock;
+
+	using json_type          = WebView::string_type;
+	namespace json           = gal::web_view::impl::json;
+	namespace process_memory = gal::web_view::impl::process_memory;
+
+	struct options_type
+	{
+		bool        quick;
+		std::string output;
+	};
+
+	[[nodiscard]] auto to_ms(const clock_type::duration duration) -> double { return std::chrono::duration<double, std::milli>{duration}.count(); }
+
+	// KiB, this process and the WebKit processes it spawned
+	[[nodiscard]] auto total_resident_set_size() -> std::size_t
+	{
+		return process_memory::resident_set_size() + process_memory::descendants_resident_set_size();
+	}
+
+	// Sorts the samples.
+	auto append_percentiles(json_type& out, std::vector<double>& samples) -> void
+	{
+		std::ranges::sort(samples);
+
+		const auto at = [&samples](const std::size_t percent) -> double { return samples.empty() ? 0 : samples[std::min(samples.size() - 1, samples.size() * percent / 100)]; };
+
+		out.append("{\"samples\":");
+		json::append(out, samples.size());
+		out.append(",\"p50_ms\":");
+		json::append(out, at(50));
+		out.append(",\"p99_ms\":");
+		json::append(out, at(99));
+		out.append(",\"max_ms\":");
+		json::append(out, samples.empty() ? 0 : samples.back());
+		out.append("}");
+	}
+
+	// Runs the loop until `window.external.bench_done()` is called.
+	auto run_script(WebView& web_view, bool& done, const std::string_view script) -> bool
+	{
+		done = false;
+		web_view.eval_async(script);
+		while (!done && web_view.iteration()) {}
+		return done;
+	}
+
+	class Benchmark
+	{
+	public:
+		using size_type = std::size_t;
+
+	private:
+		options_type options_;
+		WebView      web_view_;
+		bool         done_;
+
+		std::vector<double> latencies_;
+
+		[[nodiscard]] auto count(const size_type full, const size_type quick) const noexcept -> size_type { return options_.quick ? quick : full; }
+
+	public:
+		explicit Benchmark(options_type&& options)
+			: options_{std::move(options)},
+			  web_view_{
+					  /*.window_width = */ 800,
+					  /*.window_height = */ 600,
+					  /*.window_title = */ "webview_bench",
+					  /*.window_is_fixed = */ false,
+					  /*.window_is_fullscreen = */ false,
+					  /*.web_view_use_dev_tools = */ false,
+					  /*.index_url = */ WebView::string_type{WebView::default_index_url},
+					  /*.headless = */ true},
+			  done_{false}
+		{
+			web_view_.bind("bench_done", [this](WebView&, WebView::string_view_type) -> void { done_ = true; });
+			// the sink of the throughput benchmarks, do nothing but settling the call
+			web_view_.bind("bench_sink", [](WebView&, WebView::string_view_type) -> void {});
+			web_view_.bind("bench_binary_sink", [](WebView&, WebView::bytes_view_type) -> void {});
+			web_view_.bind(
+					"bench_latency",
+					[this](WebView& wv, const WebView::call_id_type id, const WebView::string_view_type sent) -> void
+					{
+						// `performance.timeOrigin + performance.now()`, the same clock as the system clock (ms since the epoch)
+						const auto now = std::chrono::duration<double, std::milli>{std::chrono::system_clock::now().time_since_epoch()}.count();
+
+						double sent_time = 0;
+						std::from_chars(sent.data(), sent.data() + sent.size(), sent_time);
+						latencies_.push_back(now - sent_time);
+						wv.resolve(id);
+					});
+		}
+
+		// construction => service_start => the first script (evaluated once the first load finished)
+		[[nodiscard]] auto cold_start(json_type& out, const clock_type::time_point construction_time) -> bool
+		{
+			if (web_view_.service_start() != gal::web_view::ServiceStartResult::SUCCESS) { return false; }
+			const auto started_time = clock_type::now();
+
+			if (web_view_.eval("1").result != gal::web_view::EvalResult::SUCCESS) { return false; }
+			const auto loaded_time = clock_type::now();
+
+			out.append("\"cold_start\":{\"service_start_ms\":");
+			json::append(out, to_ms(started_time - construction_time));
+			out.append(",\"first_load_ms\":");
+			json::append(out, to_ms(loaded_time - construction_time));
+			out.append(",\"rss_kib\":");
+			json::append(out, total_resident_set_size());
+			out.append("}");
+			return true;
+		}
+
+		// javascript => native, one message at a time
+		[[nodiscard]] auto message_latency(json_type& out) -> bool
+		{
+			latencies_.clear();
+			latencies_.reserve(count(10'000, 500));
+
+			const auto script = json_type{"(async()=>{for(let i=0;i<"}
+			                            .append(std::to_string(count(10'000, 500)))
+			                            .append(
+					                            ";++i){await window.external.bench_latency(String(performance.timeOrigin+performance.now()));}"
+					                            "window.external.bench_done();})()");
+			if (!run_script(web_view_, done_, script)) { return false; }
+
+			out.append("\"message_latency\":");
+			append_percentiles(out, latencies_);
+			return true;
+		}
+
+		// native => javascript => native
+		[[nodiscard]] auto eval_round_trip(json_type& out) -> bool
+		{
+			const auto          evaluations = count(10'000, 500);
+			std::vector<double> samples{};
+			samples.reserve(evaluations);
+
+			for (size_type i = 0; i < evaluations; ++i)
+			{
+				const auto begin = clock_type::now();
+				if (web_view_.eval("1").result != gal::web_view::EvalResult::SUCCESS) { return false; }
+				samples.push_back(to_ms(clock_type::now() - begin));
+			}
+
+			out.append("\"eval_round_trip\":");
+			append_percentiles(out, samples);
+			return true;
+		}
+
+		// messages/s and bytes/s for every payload size, both string and binary
+		[[nodiscard]] auto throughput(json_type& out) -> bool
+		{
+			out.append("\"throughput\":[");
+
+			bool first = true;
+			for (const auto binary: {false, true})
+			{
+				// 16 B => 16 MiB
+				for (size_type size = 16; size <= 16 * 1024 * 1024; size *= 16)
+				{
+					// about 256 MiB (16 MiB in quick mode) per payload size, but at least 4 messages
+					const auto messages = std::clamp<size_type>(count(256, 16) * 1024 * 1024 / size, 4, count(100'000, 5'000));
+
+					const auto script = json_type{"(async()=>{const payload="}
+					                            .append(binary ? "new Uint8Array(" : "'x'.repeat(")
+					                            .append(std::to_string(size))
+					                            .append(");for(let i=0;i<")
+					                            .append(std::to_string(messages))
+					                            .append(";++i){const p=window.external.")
+					                            .append(binary ? "bench_binary_sink" : "bench_sink")
+					                            // do not let the pending calls pile up
+					                            .append("(payload);if(i%64===63){await p;}}window.external.bench_done();})()");
+
+					const auto begin = clock_type::now();
+					if (!run_script(web_view_, done_, script)) { return false; }
+					const auto seconds = std::chrono::duration<double>{clock_type::now() - begin}.count();
+
+					if (!first) { out.push_back(','); }
+					first = false;
+
+					out.append("{\"payload\":");
+					json::append(out, binary ? "binary" : "string");
+					out.append(",\"bytes\":");
+					json::append(out, size);
+					out.append(",\"messages\":");
+					json::append(out, messages);
+					out.append(",\"messages_per_second\":");
+					json::append(out, static_cast<double>(messages) / seconds);
+					out.append(",\"bytes_per_second\":");
+					json::append(out, static_cast<double>(messages * size) / seconds);
+					out.append("}");
+				}
+			}
+
+			out.append("]");
+			return true;
+		}
+
+		// memory growth over a (very) long session
+		[[nodiscard]] auto rss_growth(json_type& out) -> bool
+		{
+			const auto messages = count(1'000'000, 50'000);
+
+			const auto before = total_resident_set_size();
+			const auto script = json_type{"(async()=>{for(let i=0;i<"}
+			                            .append(std::to_string(messages))
+			                            .append(";++i){const p=window.external.bench_sink('x');if(i%1024===1023){await p;}}window.external.bench_done();})()");
+			if (!run_script(web_view_, done_, script)) { return false; }
+			const auto after = total_resident_set_size();
+
+			out.append("\"rss_growth\":{\"messages\":");
+			json::append(out, messages);
+			out.append(",\"before_kib\":");
+			json::append(out, before);
+			out.append(",\"after_kib\":");
+			json::append(out, after);
+			out.append(",\"growth_kib\":");
+			json::append(out, static_cast<double>(after) - static_cast<double>(before));
+			out.append("}");
+			return true;
+		}
+
+		// memory of every extra web view sharing one context, for both process models
+		[[nodiscard]] auto view_memory(json_type& out) const -> bool
+		{
+			const auto views = count(8, 4);
+
+			out.append("\"view_memory\":[");
+			for (const auto process_model: {WebViewHost::ProcessModel::SHARED, WebViewHost::ProcessModel::PER_VIEW})
+			{
+				WebViewHost host{{.process_model = process_model}};
+				if (!host.initialized()) { return false; }
+
+				std::vector<std::unique_ptr<WebView>> web_views{};
+				std::vector<std::size_t>              rss{total_resident_set_size()};
+				for (size_type i = 0; i < views; ++i)
+				{
+					auto& web_view = *web_views.emplace_back(
+							std::make_unique<WebView>(
+									host,
+									/*.window_width = */ 800,
+									/*.window_height = */ 600,
+									/*.window_title = */ "webview_bench",
+									/*.window_is_fixed = */ false,
+									/*.window_is_fullscreen = */ false,
+									/*.web_view_use_dev_tools = */ false,
+									/*.index_url = */ WebView::string_type{WebView::default_index_url},
+									/*.headless = */ true));
+					if (web_view.service_start() != gal::web_view::ServiceStartResult::SUCCESS) { return false; }
+					// loaded
+					if (web_view.eval("1").result != gal::web_view::EvalResult::SUCCESS) { return false; }
+					rss.push_back(total_resident_set_size());
+				}
+				for (const auto& web_view: web_views) { web_view->shutdown(); }
+
+				if (process_model != WebViewHost::ProcessModel::SHARED) { out.push_back(','); }
+				out.append("{\"process_model\":");
+				json::append(out, process_model == WebViewHost::ProcessModel::SHARED ? "shared" : "per_view");
+				out.append(",\"views\":");
+				json::append(out, views);
+				out.append(",\"first_view_kib\":");
+				json::append(out, static_cast<double>(rss[1]) - static_cast<double>(rss[0]));
+				out.append(",\"per_extra_view_kib\":");
+				json::append(out, (static_cast<double>(rss.back()) - static_cast<double>(rss[1])) / static_cast<double>(views - 1));
+				out.append("}");
+			}
+			out.append("]");
+			return true;
+		}
+
+		// a new web view => the first script evaluated in it, created on demand vs acquired from a (full) pool
+		[[nodiscard]] auto open_latency(json_type& out) -> bool
+		{
+			const auto make_web_view = []() -> std::unique_ptr<WebView>
+			{
+				return std::make_unique<WebView>(
+						/*.window_width = */ 800,
+						/*.window_height = */ 600,
+						/*.window_title = */ "webview_bench",
+						/*.window_is_fixed = */ false,
+						/*.window_is_fullscreen = */ false,
+						/*.web_view_use_dev_tools = */ false,
+						/*.index_url = */ WebView::string_type{WebView::default_index_url},
+						/*.headless = */ true);
+			};
+			const auto first_script = [](WebView& web_view, const clock_type::time_point begin) -> double
+			{
+				if (web_view.eval("1").result != gal::web_view::EvalResult::SUCCESS) { return -1; }
+				return to_ms(clock_type::now() - begin);
+			};
+
+			auto       begin   = clock_type::now();
+			auto       cold    = make_web_view();
+			const auto cold_ms = cold->service_start() == gal::web_view::ServiceStartResult::SUCCESS ? first_script(*cold, begin) : -1;
+			cold.reset();
+
+			WebViewPool pool{1, make_web_view};
+			// let the pool fill (and load) its web view
+			while (pool.size() != pool.capacity() && web_view_.iteration()) {}
+			for (const auto end = clock_type::now() + std::chrono::seconds{1}; clock_type::now() < end;) { web_view_.iteration(std::chrono::milliseconds{10}); }
+
+			begin                = clock_type::now();
+			auto       pooled    = pool.acquire();
+			const auto pooled_ms = pooled ? first_script(*pooled, begin) : -1;
+
+			out.append("\"open_latency\":{\"cold_ms\":");
+			json::append(out, cold_ms);
+			out.append(",\"pooled_ms\":");
+			json::append(out, pooled_ms);
+			out.append("}");
+			return cold_ms >= 0 && pooled_ms >= 0;
+		}
+
+		auto shutdown() -> void { web_view_.shutdown(); }
+	};
+}// namespace
+
+auto main(
+		const int argc,
+		char*     argv[]) -> int
+{
+	const auto construction_time = clock_type::now();
+
+	options_type options{.quick = false, .output = {}};
+	for (int i = 1; i < argc; ++i)
+	{
+		if (const std::string_view arg{argv[i]}; arg == "--quick") { options.quick = true; }
+		else { options.output = arg; }
+	}
+	const auto output = options.output;
+
+	Benchmark benchmark{std::move(options)};
+
+	json_type result{"{\"version\":"};
+	json::append(result, GAL_WEBVIEW_VERSION);
+	result.push_back(',');
+
+	if (!benchmark.cold_start(result, construction_time)) { return -1; }
+	result.push_back(',');
+	if (!benchmark.message_latency(result)) { return -2; }
+	result.push_back(',');
+	if (!benchmark.eval_round_trip(result)) { return -3; }
+	result.push_back(',');
+	if (!benchmark.throughput(result)) { return -4; }
+	result.push_back(',');
+	if (!benchmark.rss_growth(result)) { return -5; }
+	result.push_back(',');
+	if (!benchmark.view_memory(result)) { return -6; }
+	result.push_back(',');
+	if (!benchmark.open_latency(result)) { return -7; }
+	result.append("}\n");
+
+	benchmark.shutdown();
+
+	if (output.empty()) { std::fwrite(result.data(), 1, result.size(), stdout); }
+	else
+	{
+		std::ofstream file{output, std::ios::out | std::ios::trunc};
+		if (!file.is_open()) { return -8; }
+		file.write(result.data(), static_cast<std::streamsize>(result.size()));
+	}
+	return 0;
+}
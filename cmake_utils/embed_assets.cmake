@@ -0,0 +1,86 @@
+# Packs every file of a directory into a generated translation unit of `target`.
+#   gal_webview_embed_assets(
+#       <target>
+#       DIR <directory>
+#       [NAME <identifier>]  # defaults to `<target>_assets`
+#       [COMPRESS]           # store the files gzip compressed (if gzip is available)
+#   )
+# The generated header `<name>.hpp` declares `gal::web_view::embedded::<name>()`, which returns the (sorted) index of the assets:
+#   #include <<name>.hpp>
+#   registry.add(gal::web_view::embedded::<name>());
+# The files are regenerated when one of them changes, a file added to (or removed from) the directory requires a re-configure.
+function(
+		gal_webview_embed_assets
+		target
+)
+	cmake_parse_arguments(
+			EMBED
+			"COMPRESS"
+			"DIR;NAME"
+			""
+			${ARGN}
+	)
+
+	if (NOT EMBED_DIR)
+		message(FATAL_ERROR "gal_webview_embed_assets: DIR is required!")
+	endif (NOT EMBED_DIR)
+	get_filename_component(EMBED_DIR ${EMBED_DIR} ABSOLUTE)
+
+	if (NOT EMBED_NAME)
+		string(MAKE_C_IDENTIFIER "${target}_assets" EMBED_NAME)
+	endif (NOT EMBED_NAME)
+
+	set(EMBED_GZIP "")
+	if (EMBED_COMPRESS)
+		find_program(GAL_WEBVIEW_GZIP_PROGRAM gzip)
+		if (GAL_WEBVIEW_GZIP_PROGRAM)
+			set(EMBED_GZIP ${GAL_WEBVIEW_GZIP_PROGRAM})
+		else ()
+			message(WARNING "gal_webview_embed_assets: gzip not found, the assets of [${target}] are stored uncompressed.")
+		endif (GAL_WEBVIEW_GZIP_PROGRAM)
+	endif (EMBED_COMPRESS)
+
+	file(
+			GLOB_RECURSE
+			EMBED_FILES
+			CONFIGURE_DEPENDS
+			LIST_DIRECTORIES false
+
+			${EMBED_DIR}/*
+	)
+
+	set(EMBED_OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/gal_webview_assets/${EMBED_NAME})
+	set(EMBED_SCRIPT ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/embed_assets_generate.cmake)
+
+	add_custom_command(
+			OUTPUT
+			${EMBED_OUTPUT_DIR}/${EMBED_NAME}.hpp
+			${EMBED_OUTPUT_DIR}/${EMBED_NAME}.cpp
+
+			COMMAND ${CMAKE_COMMAND}
+			-DEMBED_NAME=${EMBED_NAME}
+			-DEMBED_DIR=${EMBED_DIR}
+			-DEMBED_OUTPUT_DIR=${EMBED_OUTPUT_DIR}
+			-DEMBED_GZIP=${EMBED_GZIP}
+			-P ${EMBED_SCRIPT}
+
+			DEPENDS ${EMBED_FILES} ${EMBED_SCRIPT}
+			COMMENT "Embedding assets of [${EMBED_DIR}] into [${target}]"
+			VERBATIM
+	)
+
+	target_sources(
+			${target}
+			PRIVATE
+
+			${EMBED_OUTPUT_DIR}/${EMBED_NAME}.hpp
+			${EMBED_OUTPUT_DIR}/${EMBED_NAME}.cpp
+	)
+
+	target_include_directories(
+			${target}
+			PRIVATE
+
+			${EMBED_OUTPUT_DIR}
+	)
+endfunction(gal_webview_embed_assets)
@@ -0,0 +1,127 @@
+# Invoked by `gal_webview_embed_assets` (cmake -P), generates `<EMBED_NAME>.hpp` / `<EMBED_NAME>.cpp` in EMBED_OUTPUT_DIR.
+#   EMBED_NAME: the name of the generated function
+#   EMBED_DIR: the directory of the assets
+#   EMBED_OUTPUT_DIR: where to generate the files
+#   EMBED_GZIP: the gzip program, empty if the assets are not compressed
+
+file(MAKE_DIRECTORY ${EMBED_OUTPUT_DIR})
+
+file(
+		GLOB_RECURSE
+		EMBED_FILES
+		LIST_DIRECTORIES false
+		RELATIVE ${EMBED_DIR}
+
+		${EMBED_DIR}/*
+)
+# std::string_view compares bytes, so does STRING (with the default case sensitivity)
+list(SORT EMBED_FILES COMPARE STRING)
+
+set(EMBED_DATA "")
+set(EMBED_INDEX "")
+set(EMBED_ID 0)
+foreach (EMBED_FILE IN LISTS EMBED_FILES)
+	set(EMBED_PATH ${EMBED_DIR}/${EMBED_FILE})
+
+	# the name in a string literal (in the comment too, a trailing backslash would continue it)
+	string(REPLACE "\\" "\\\\" EMBED_FILE_LITERAL "${EMBED_FILE}")
+	string(REPLACE "\"" "\\\"" EMBED_FILE_LITERAL "${EMBED_FILE_LITERAL}")
+	string(REPLACE "\n" "\\n" EMBED_FILE_LITERAL "${EMBED_FILE_LITERAL}")
+
+	# the etag comes from the original content
+	file(SHA256 ${EMBED_PATH} EMBED_HASH)
+	string(SUBSTRING ${EMBED_HASH} 0 16 EMBED_HASH)
+
+	set(EMBED_ENCODING "")
+	file(SIZE ${EMBED_PATH} EMBED_SIZE)
+	if (EMBED_GZIP)
+		set(EMBED_COMPRESSED ${EMBED_OUTPUT_DIR}/${EMBED_ID}.gz)
+		execute_process(
+				COMMAND ${EMBED_GZIP} -9 -n -c ${EMBED_PATH}
+				OUTPUT_FILE ${EMBED_COMPRESSED}
+				RESULT_VARIABLE EMBED_GZIP_RESULT
+		)
+
+		# only keep it if it is worth it
+		if (EMBED_GZIP_RESULT EQUAL 0)
+			file(SIZE ${EMBED_COMPRESSED} EMBED_COMPRESSED_SIZE)
+			if (EMBED_COMPRESSED_SIZE LESS EMBED_SIZE)
+				set(EMBED_PATH ${EMBED_COMPRESSED})
+				set(EMBED_SIZE ${EMBED_COMPRESSED_SIZE})
+				set(EMBED_ENCODING "gzip")
+			endif (EMBED_COMPRESSED_SIZE LESS EMBED_SIZE)
+		endif (EMBED_GZIP_RESULT EQUAL 0)
+	endif (EMBED_GZIP)
+
+	file(READ ${EMBED_PATH} EMBED_HEX HEX)
+	if (EMBED_GZIP)
+		file(REMOVE ${EMBED_COMPRESSED})
+	endif (EMBED_GZIP)
+	string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," EMBED_HEX "${EMBED_HEX}")
+	# 32 bytes per line
+	string(REGEX REPLACE "((0x[0-9a-f][0-9a-f],){32})" "\\1\n\t\t\t" EMBED_HEX "${EMBED_HEX}")
+	if (EMBED_SIZE EQUAL 0)
+		# zero-sized arrays are not allowed
+		set(EMBED_HEX "0x00,")
+	endif (EMBED_SIZE EQUAL 0)
+
+	string(APPEND EMBED_DATA "\t\t// \"${EMBED_FILE_LITERAL}\"\n\t\tconstexpr unsigned char data_${EMBED_ID}[]{\n\t\t\t${EMBED_HEX}\n\t\t};\n\n")
+	string(APPEND EMBED_INDEX "\t\t\t\t{.path = \"/${EMBED_FILE_LITERAL}\", .mime_type = gal::web_view::impl::mime_type_of(\"${EMBED_FILE_LITERAL}\"), .etag = R\"(\"${EMBED_HASH}\")\", .encoding = \"${EMBED_ENCODING}\", .data = data_${EMBED_ID}, .size = ${EMBED_SIZE}},\n")
+
+	math(EXPR EMBED_ID "${EMBED_ID} + 1")
+endforeach (EMBED_FILE IN LISTS EMBED_FILES)
+
+if (EMBED_ID EQUAL 0)
+	message(WARNING "No asset found in [${EMBED_DIR}]!")
+	# zero-sized arrays are not allowed
+	set(EMBED_INDEX "\t\t\t\t{.path = \"\", .mime_type = \"\", .etag = \"\", .encoding = \"\", .data = nullptr, .size = 0},\n")
+	set(EMBED_INDEX_SIZE 0)
+else ()
+	set(EMBED_INDEX_SIZE ${EMBED_ID})
+endif (EMBED_ID EQUAL 0)
+
+# only touch the files if something changed, so that the dependents are not rebuilt for nothing
+file(
+		CONFIGURE
+		OUTPUT ${EMBED_OUTPUT_DIR}/${EMBED_NAME}.hpp
+		CONTENT
+		"// Generated by gal_webview_embed_assets, do not edit.
+#pragma once
+
+#include <webview/impl/v3/embedded_asset.hpp>
+
+namespace gal::web_view::embedded
+{
+	[[nodiscard]] auto ${EMBED_NAME}() noexcept -> impl::EmbeddedAssetIndex;
+}
+"
+		@ONLY
+)
+
+file(
+		CONFIGURE
+		OUTPUT ${EMBED_OUTPUT_DIR}/${EMBED_NAME}.cpp
+		CONTENT
+		"// Generated by gal_webview_embed_assets, do not edit.
+#include <${EMBED_NAME}.hpp>
+#include <webview/impl/v3/asset.hpp>
+#include <algorithm>
+
+namespace
+{
+	namespace ${EMBED_NAME}_detail
+	{
+${EMBED_DATA}		constexpr gal::web_view::impl::EmbeddedAsset assets[]{
+${EMBED_INDEX}		};
+
+		static_assert(std::ranges::is_sorted(assets, {}, &gal::web_view::impl::EmbeddedAsset::path), \"The assets must be sorted by path!\");
+	}
+}
+
+namespace gal::web_view::embedded
+{
+	auto ${EMBED_NAME}() noexcept -> impl::EmbeddedAssetIndex { return impl::EmbeddedAssetIndex{std::span{${EMBED_NAME}_detail::assets}.first(${EMBED_INDEX_SIZE})}; }
+}
+"
+		@ONLY
+)
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <webview/impl/v3/binding_table.hpp>
+#include <webview/impl/v3/embedded_asset.hpp>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		[[nodiscard]] constexpr auto mime_type_of(const std::string_view path) noexcept -> std::string_view
+		{
+			constexpr std::pair<std::string_view, std::string_view> types[]{
+					{".html", "text/html; charset=utf-8"},
+					{".htm", "text/html; charset=utf-8"},
+					{".js", "text/javascript; charset=utf-8"},
+					{".mjs", "text/javascript; charset=utf-8"},
+					{".css", "text/css; charset=utf-8"},
+					{".json", "application/json"},
+					{".map", "application/json"},
+					{".txt", "text/plain; charset=utf-8"},
+					{".xml", "application/xml"},
+					{".svg", "image/svg+xml"},
+					{".png", "image/png"},
+					{".jpg", "image/jpeg"},
+					{".jpeg", "image/jpeg"},
+					{".gif", "image/gif"},
+					{".webp", "image/webp"},
+					{".ico", "image/x-icon"},
+					{".wasm", "application/wasm"},
+					{".woff", "font/woff"},
+					{".woff2", "font/woff2"},
+					{".ttf", "font/ttf"},
+					{".mp3", "audio/mpeg"},
+					{".wav", "audio/wav"},
+					{".mp4", "video/mp4"},
+					{".webm", "video/webm"},
+			};
+
+			const auto dot = path.rfind('.');
+			if (dot == std::string_view::npos) { return "application/octet-stream"; }
+
+			const auto extension = path.substr(dot);
+			for (const auto& [ext, type]: types)
+			{
+				if (ext.size() != extension.size()) { continue; }
+
+				bool same = true;
+				for (std::size_t i = 0; i < ext.size() && same; ++i)
+				{
+					const auto c = extension[i];
+					same         = ext[i] == (c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+				}
+				if (same) { return type; }
+			}
+			return "application/octet-stream";
+		}
+
+		// Assets served by a custom scheme (see `WebViewBase::register_scheme`), keyed by the path of the url (`app:///index.html` => `/index.html`).
+		// The registry is only accessed on the loop thread, and it must outlive the web views using it.
+		class AssetRegistry
+		{
+		public:
+			using string_type      = std::string;
+			using string_view_type = std::string_view;
+			using size_type        = std::uint64_t;
+			using bytes_view_type  = std::span<const std::byte>;
+
+			enum class Kind : std::uint8_t
+			{
+				// The bytes are in memory (owned by the registry or static)
+				MEMORY,
+				// The file is streamed from the disk on each request
+				FILE,
+			};
+
+			struct asset_type
+			{
+				Kind        kind;
+				string_type mime_type;
+				string_type etag;
+				// Empty if the bytes are stored as is, otherwise the `Content-Encoding` of them (the size is the encoded size)
+				string_type encoding;
+				size_type   size;
+
+				// MEMORY
+				bytes_view_type             bytes;
+				std::shared_ptr<const void> owner;
+
+				// FILE
+				std::filesystem::path path;
+			};
+
+			struct request_type
+			{
+				string_view_type method;
+				string_view_type path;
+				// the `Range` header, if any
+				string_view_type range;
+				// the `If-None-Match` header, if any
+				string_view_type if_none_match;
+			};
+
+			struct response_type
+			{
+				int status;
+				// nullptr if not found
+				const asset_type* asset;
+				// [offset, offset + length) of the asset should be sent
+				size_type offset;
+				size_type length;
+				// HEAD / 304 have no body
+				bool with_body;
+			};
+
+			constexpr static string_view_type index_path{"/index.html"};
+
+		private:
+			BindingTable<asset_type> assets_;
+
+			// FNV-1a
+			[[nodiscard]] static auto make_etag(const bytes_view_type bytes) -> string_type
+			{
+				std::uint64_t hash = 0xcbf29ce484222325ull;
+				for (const auto b: bytes)
+				{
+					hash ^= static_cast<std::uint8_t>(b);
+					hash *= 0x100000001b3ull;
+				}
+
+				string_type etag{"\""};
+				char        buffer[16];
+				const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), hash, 16);
+				etag.append(buffer, ptr).push_back('"');
+				return etag;
+			}
+
+			// bytes=first-last / bytes=first- / bytes=-suffix, multiple ranges are not supported (the whole asset is sent)
+			[[nodiscard]] static auto parse_range(string_view_type range, const size_type size, size_type& offset, size_type& length) -> bool
+			{
+				constexpr string_view_type prefix{"bytes="};
+				if (size == 0 || !range.starts_with(prefix) || range.find(',') != string_view_type::npos) { return false; }
+				range.remove_prefix(prefix.size());
+
+				const auto dash = range.find('-');
+				if (dash == string_view_type::npos) { return false; }
+
+				const auto first_part = range.substr(0, dash);
+				const auto last_part  = range.substr(dash + 1);
+
+				const auto parse = [](const string_view_type string, size_type& value) -> bool
+				{
+					const auto [ptr, ec] = std::from_chars(string.data(), string.data() + string.size(), value);
+					return ec == std::errc{} && ptr == string.data() + string.size();
+				};
+
+				size_type first = 0;
+				size_type last  = 0;
+				if (first_part.empty())
+				{
+					// suffix
+					if (!parse(last_part, last) || last == 0) { return false; }
+					first = last >= size ? 0 : size - last;
+					last  = size - 1;
+				}
+				else
+				{
+					if (!parse(first_part, first)) { return false; }
+					if (last_part.empty()) { last = size - 1; }
+					else if (!parse(last_part, last) || last < first) { return false; }
+					if (last >= size) { last = size - 1; }
+				}
+
+				offset = first;
+				length = last - first + 1;
+				return first < size;
+			}
+
+		public:
+			// The bytes are not copied, they must outlive the registry (e.g. static data).
+			auto add_static(const string_view_type path, const bytes_view_type bytes, const string_view_type mime_type = {}) -> void
+			{
+				assets_.insert(
+						path,
+						{.kind      = Kind::MEMORY,
+						 .mime_type = string_type{mime_type.empty() ? mime_type_of(path) : mime_type},
+						 .etag      = make_etag(bytes),
+						 .encoding  = {},
+						 .size      = bytes.size(),
+						 .bytes     = bytes,
+						 .owner     = nullptr,
+						 .path      = {}});
+			}
+
+			auto add(const string_view_type path, std::vector<std::byte>&& bytes, const string_view_type mime_type = {}) -> void
+			{
+				auto owner = std::make_shared<const std::vector<std::byte>>(std::move(bytes));
+
+				assets_.insert(
+						path,
+						{.kind      = Kind::MEMORY,
+						 .mime_type = string_type{mime_type.empty() ? mime_type_of(path) : mime_type},
+						 .etag      = make_etag(*owner),
+						 .encoding  = {},
+						 .size      = owner->size(),
+						 .bytes     = *owner,
+						 .owner     = owner,
+						 .path      = {}});
+			}
+
+			auto add(const string_view_type path, const string_view_type content, const string_view_type mime_type = {}) -> void
+			{
+				const auto bytes = std::as_bytes(std::span{content});
+				add(path, std::vector<std::byte>{bytes.begin(), bytes.end()}, mime_type);
+			}
+
+			// Assets generated by `gal_webview_embed_assets`, the bytes are not copied (or hashed), they are served from the static data.
+			// Once added they are looked up like any other asset (no allocation, no file I/O).
+			auto add(const EmbeddedAssetIndex& index) -> void
+			{
+				for (const auto& asset: index)
+				{
+					assets_.insert(
+							asset.path,
+							{.kind      = Kind::MEMORY,
+							 .mime_type = string_type{asset.mime_type},
+							 .etag      = string_type{asset.etag},
+							 .encoding  = string_type{asset.encoding},
+							 .size      = asset.size,
+							 .bytes     = asset.bytes(),
+							 .owner     = nullptr,
+							 .path      = {}});
+				}
+			}
+
+			// The file is not read until it is requested, and it is streamed.
+			// Returns false if the file does not exist.
+			auto add_file(const string_view_type path, std::filesystem::path file, const string_view_type mime_type = {}) -> bool
+			{
+				std::error_code ec;
+				const auto      size = std::filesystem::file_size(file, ec);
+				if (ec) { return false; }
+				const auto time = std::filesystem::last_write_time(file, ec);
+				if (ec) { return false; }
+
+				// size-mtime, like most http servers do
+				string_type etag{"\""};
+				char        buffer[32];
+				const auto  size_result = std::to_chars(buffer, buffer + sizeof(buffer), size, 16);
+				etag.append(buffer, size_result.ptr).push_back('-');
+				const auto time_result = std::to_chars(buffer, buffer + sizeof(buffer), time.time_since_epoch().count(), 16);
+				etag.append(buffer, time_result.ptr).push_back('"');
+
+				assets_.insert(
+						path,
+						{.kind      = Kind::FILE,
+						 .mime_type = string_type{mime_type.empty() ? mime_type_of(path) : mime_type},
+						 .etag      = std::move(etag),
+						 .encoding  = {},
+						 .size      = size,
+						 .bytes     = {},
+						 .owner     = nullptr,
+						 .path      = std::move(file)});
+				return true;
+			}
+
+			auto erase(const string_view_type path) -> bool { return assets_.erase(path); }
+
+			[[nodiscard]] auto find(const string_view_type path) const noexcept -> const asset_type*
+			{
+				return assets_.find(path.empty() || path == "/" ? index_path : path);
+			}
+
+			[[nodiscard]] auto respond(const request_type& request) const noexcept -> response_type
+			{
+				const auto is_head = request.method == "HEAD";
+				if (!is_head && !request.method.empty() && request.method != "GET") { return {.status = 405, .asset = nullptr, .offset = 0, .length = 0, .with_body = false}; }
+
+				const auto* asset = find(request.path);
+				if (!asset) { return {.status = 404, .asset = nullptr, .offset = 0, .length = 0, .with_body = false}; }
+
+				if (!request.if_none_match.empty() && request.if_none_match.find(asset->etag) != string_view_type::npos) { return {.status = 304, .asset = asset, .offset = 0, .length = 0, .with_body = false}; }
+
+				// The range of an encoded asset would be a range of the decoded bytes, which are unknown until they are decoded
+				if (!request.range.empty() && asset->encoding.empty())
+				{
+					size_type offset;
+					size_type length;
+					if (!parse_range(request.range, asset->size, offset, length)) { return {.status = 416, .asset = asset, .offset = 0, .length = 0, .with_body = false}; }
+					return {.status = 206, .asset = asset, .offset = offset, .length = length, .with_body = !is_head};
+				}
+
+				return {.status = 200, .asset = asset, .offset = 0, .length = asset->size, .with_body = !is_head};
+			}
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
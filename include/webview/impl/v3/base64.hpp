@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// Only used where a backend cannot transfer bytes directly.
+		namespace base64
+		{
+			constexpr std::string_view alphabet{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+			template<typename String>
+			auto encode(String& out, const std::span<const std::byte> bytes) -> void
+			{
+				const auto* data = reinterpret_cast<const std::uint8_t*>(bytes.data());
+				const auto  size = bytes.size();
+
+				std::size_t i = 0;
+				for (; i + 3 <= size; i += 3)
+				{
+					const auto v = static_cast<std::uint32_t>(data[i] << 16 | data[i + 1] << 8 | data[i + 2]);
+					const char block[]{alphabet[v >> 18 & 0x3f], alphabet[v >> 12 & 0x3f], alphabet[v >> 6 & 0x3f], alphabet[v & 0x3f]};
+					out.append(block, sizeof(block));
+				}
+
+				if (const auto rest = size - i; rest == 1)
+				{
+					const auto v = static_cast<std::uint32_t>(data[i] << 16);
+					const char block[]{alphabet[v >> 18 & 0x3f], alphabet[v >> 12 & 0x3f], '=', '='};
+					out.append(block, sizeof(block));
+				}
+				else if (rest == 2)
+				{
+					const auto v = static_cast<std::uint32_t>(data[i] << 16 | data[i + 1] << 8);
+					const char block[]{alphabet[v >> 18 & 0x3f], alphabet[v >> 12 & 0x3f], alphabet[v >> 6 & 0x3f], '='};
+					out.append(block, sizeof(block));
+				}
+			}
+
+			// Returns false if the string is not valid base64.
+			template<typename Bytes>
+			[[nodiscard]] auto decode(Bytes& out, const std::string_view string) -> bool
+			{
+				constexpr auto table = []
+				{
+					std::array<std::uint8_t, 256> t{};
+					t.fill(0xff);
+					for (std::size_t i = 0; i < alphabet.size(); ++i) { t[static_cast<std::uint8_t>(alphabet[i])] = static_cast<std::uint8_t>(i); }
+					return t;
+				}();
+
+				if (string.size() % 4 != 0) { return false; }
+
+				auto size = string.size();
+				if (size != 0 && string[size - 1] == '=') { --size; }
+				if (size != 0 && string[size - 1] == '=') { --size; }
+
+				std::uint32_t buffer = 0;
+				int           bits   = 0;
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					const auto v = table[static_cast<std::uint8_t>(string[i])];
+					if (v == 0xff) { return false; }
+
+					buffer = buffer << 6 | v;
+					bits += 6;
+					if (bits >= 8)
+					{
+						bits -= 8;
+						out.push_back(static_cast<std::byte>(buffer >> bits & 0xff));
+					}
+				}
+				return true;
+			}
+		}// namespace base64
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// Open addressing (linear probing) hash table mapping method names to handlers.
+		// The hashes are stored in their own array, so a lookup only touches the entry whose hash matches,
+		// and it is done with a string_view (no temporary string).
+		template<typename Handler>
+		class BindingTable
+		{
+		public:
+			using handler_type     = Handler;
+			using string_type      = std::string;
+			using string_view_type = std::string_view;
+			using hash_type        = std::size_t;
+			using size_type        = std::size_t;
+
+			struct entry_type
+			{
+				string_type  name;
+				handler_type handler;
+			};
+
+		private:
+			// 0 is reserved for empty slots
+			constexpr static hash_type empty_hash{0};
+			constexpr static size_type initial_capacity{16};
+
+			std::vector<hash_type>  hashes_;
+			std::vector<entry_type> entries_;
+			size_type               size_{0};
+
+			[[nodiscard]] static auto hash_of(const string_view_type name) noexcept -> hash_type
+			{
+				const auto hash = std::hash<string_view_type>{}(name);
+				return hash == empty_hash ? 1 : hash;
+			}
+
+			[[nodiscard]] auto mask() const noexcept -> size_type { return hashes_.size() - 1; }
+
+			[[nodiscard]] auto find_slot(const string_view_type name, const hash_type hash) const noexcept -> size_type
+			{
+				for (auto index = hash & mask();; index = (index + 1) & mask())
+				{
+					if (hashes_[index] == empty_hash) { return index; }
+					if (hashes_[index] == hash && entries_[index].name == name) { return index; }
+				}
+			}
+
+			auto rehash(const size_type new_capacity) -> void
+			{
+				auto old_hashes  = std::exchange(hashes_, std::vector<hash_type>(new_capacity, empty_hash));
+				auto old_entries = std::exchange(entries_, std::vector<entry_type>(new_capacity));
+
+				for (size_type i = 0; i < old_hashes.size(); ++i)
+				{
+					if (old_hashes[i] == empty_hash) { continue; }
+
+					const auto index = find_slot(old_entries[i].name, old_hashes[i]);
+					hashes_[index]   = old_hashes[i];
+					entries_[index]  = std::move(old_entries[i]);
+				}
+			}
+
+		public:
+			[[nodiscard]] auto size() const noexcept -> size_type { return size_; }
+
+			[[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+			// Insert or replace, returns true if the name was not bound before.
+			auto insert(const string_view_type name, handler_type&& handler) -> bool
+			{
+				// keep the load factor below 0.5
+				if (hashes_.empty()) { rehash(initial_capacity); }
+				else if ((size_ + 1) * 2 > hashes_.size()) { rehash(hashes_.size() * 2); }
+
+				const auto hash  = hash_of(name);
+				const auto index = find_slot(name, hash);
+				if (hashes_[index] != empty_hash)
+				{
+					entries_[index].handler = std::move(handler);
+					return false;
+				}
+
+				hashes_[index]  = hash;
+				entries_[index] = {string_type{name}, std::move(handler)};
+				++size_;
+				return true;
+			}
+
+			// Returns true if the name was bound.
+			auto erase(const string_view_type name) -> bool
+			{
+				if (empty()) { return false; }
+
+				auto index = find_slot(name, hash_of(name));
+				if (hashes_[index] == empty_hash) { return false; }
+
+				// backward shift deletion, no tombstones
+				for (auto next = (index + 1) & mask(); hashes_[next] != empty_hash; next = (next + 1) & mask())
+				{
+					const auto home = hashes_[next] & mask();
+					// can the entry at `next` be moved to `index`? (is `home` cyclically outside (index, next])
+					if ((next > index && (home <= index || home > next)) || (next < index && (home <= index && home > next)))
+					{
+						hashes_[index]  = hashes_[next];
+						entries_[index] = std::move(entries_[next]);
+						index           = next;
+					}
+				}
+
+				hashes_[index]  = empty_hash;
+				entries_[index] = {};
+				--size_;
+				return true;
+			}
+
+			[[nodiscard]] auto find(const string_view_type name) noexcept -> handler_type*
+			{
+				if (empty()) { return nullptr; }
+
+				const auto index = find_slot(name, hash_of(name));
+				if (hashes_[index] == empty_hash) { return nullptr; }
+				return &entries_[index].handler;
+			}
+
+			[[nodiscard]] auto find(const string_view_type name) const noexcept -> const handler_type*
+			{
+				if (empty()) { return nullptr; }
+
+				const auto index = find_slot(name, hash_of(name));
+				if (hashes_[index] == empty_hash) { return nullptr; }
+				return &entries_[index].handler;
+			}
+
+			template<typename Function>
+			auto for_each(Function function) const -> void
+			{
+				for (size_type i = 0; i < hashes_.size(); ++i)
+				{
+					if (hashes_[i] != empty_hash) { function(string_view_type{entries_[i].name}, entries_[i].handler); }
+				}
+			}
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// An asset compiled into the binary by `gal_webview_embed_assets` (see cmake_utils/embed_assets.cmake).
+		struct EmbeddedAsset
+		{
+			// `/index.html`
+			std::string_view path;
+			std::string_view mime_type;
+			// Computed from the original content
+			std::string_view etag;
+			// Empty if the data is stored as is, otherwise the `Content-Encoding` of it (`gzip`)
+			std::string_view encoding;
+
+			const unsigned char* data;
+			std::size_t          size;
+
+			[[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte> { return std::as_bytes(std::span{data, size}); }
+		};
+
+		// The assets are sorted by path (the generated files do not change as long as the assets do not), they are served by an `AssetRegistry`.
+		class EmbeddedAssetIndex
+		{
+		public:
+			using size_type = std::size_t;
+
+		private:
+			std::span<const EmbeddedAsset> assets_;
+
+		public:
+			constexpr explicit EmbeddedAssetIndex(const std::span<const EmbeddedAsset> assets) noexcept
+				: assets_{assets} {}
+
+			[[nodiscard]] constexpr auto size() const noexcept -> size_type { return assets_.size(); }
+
+			[[nodiscard]] constexpr auto begin() const noexcept { return assets_.begin(); }
+
+			[[nodiscard]] constexpr auto end() const noexcept { return assets_.end(); }
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
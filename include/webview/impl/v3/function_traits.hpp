@@ -0,0 +1,43 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// The return type and the parameter types of a function pointer or of a (non-generic) function object.
+		template<typename Function>
+		struct FunctionTraits : FunctionTraits<decltype(&Function::operator())> {};
+
+		template<typename R, typename... Args>
+		struct FunctionTraits<R(Args...)>
+		{
+			using signature_type = R(Args...);
+			using return_type    = R;
+			using parameter_type = std::tuple<Args...>;
+
+			constexpr static auto arity = sizeof...(Args);
+		};
+
+		template<typename R, typename... Args>
+		struct FunctionTraits<R (*)(Args...)> : FunctionTraits<R(Args...)> {};
+
+		template<typename R, typename... Args>
+		struct FunctionTraits<R (*)(Args...) noexcept> : FunctionTraits<R(Args...)> {};
+
+		// operator() of a function object
+		template<typename C, typename R, typename... Args>
+		struct FunctionTraits<R (C::*)(Args...)> : FunctionTraits<R(Args...)> {};
+
+		template<typename C, typename R, typename... Args>
+		struct FunctionTraits<R (C::*)(Args...) const> : FunctionTraits<R(Args...)> {};
+
+		template<typename C, typename R, typename... Args>
+		struct FunctionTraits<R (C::*)(Args...) noexcept> : FunctionTraits<R(Args...)> {};
+
+		template<typename C, typename R, typename... Args>
+		struct FunctionTraits<R (C::*)(Args...) const noexcept> : FunctionTraits<R(Args...)> {};
+	}// namespace v3
+}// namespace gal::web_view::impl
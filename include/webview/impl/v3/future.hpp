@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cassert>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// Single-threaded future/promise pair.
+		// The value is set and consumed on the thread running the web view loop, so no synchronization is needed,
+		// and nobody is allowed to block on it (the value can only arrive while the loop is running).
+		template<typename T>
+		class Future;
+
+		template<typename T>
+		class Promise;
+
+		namespace future_detail
+		{
+			template<typename T>
+			struct State
+			{
+				using value_type        = T;
+				using continuation_type = std::function<auto(value_type&&) -> void>;
+
+				std::optional<value_type> value;
+				continuation_type         continuation;
+			};
+		}// namespace future_detail
+
+		template<typename T>
+		class Future
+		{
+			friend Promise<T>;
+
+		public:
+			using value_type        = T;
+			using state_type        = future_detail::State<value_type>;
+			using continuation_type = typename state_type::continuation_type;
+
+		private:
+			std::shared_ptr<state_type> state_;
+
+			explicit Future(std::shared_ptr<state_type> state)
+				: state_{std::move(state)} {}
+
+		public:
+			Future() = default;
+
+			[[nodiscard]] auto valid() const noexcept -> bool { return state_ != nullptr; }
+
+			[[nodiscard]] auto ready() const noexcept -> bool { return valid() && state_->value.has_value(); }
+
+			[[nodiscard]] auto get() & -> value_type&
+			{
+				assert(ready() && "The value is not ready yet!");
+				return *state_->value;
+			}
+
+			[[nodiscard]] auto get() && -> value_type
+			{
+				assert(ready() && "The value is not ready yet!");
+				return std::move(*state_->value);
+			}
+
+			// The continuation consumes the value, it is invoked immediately if the value is already there,
+			// otherwise it is invoked (on the loop thread) once the value is set.
+			auto then(continuation_type&& continuation) -> void
+			{
+				assert(valid() && "Invalid future!");
+				assert(!state_->continuation && "Only one continuation is allowed!");
+
+				if (state_->value.has_value())
+				{
+					auto value = std::move(*state_->value);
+					state_->value.reset();
+					continuation(std::move(value));
+				}
+				else { state_->continuation.swap(continuation); }
+			}
+
+			struct awaiter
+			{
+				std::shared_ptr<state_type> state;
+				std::optional<value_type>   value;
+
+				[[nodiscard]] auto await_ready() const noexcept -> bool { return state->value.has_value(); }
+
+				// the coroutine is resumed where the value is set (on the loop thread)
+				auto await_suspend(const std::coroutine_handle<> handle) -> void
+				{
+					state->continuation = [this, handle](value_type&& v) -> void
+					{
+						value.emplace(std::move(v));
+						handle.resume();
+					};
+				}
+
+				[[nodiscard]] auto await_resume() -> value_type
+				{
+					if (value.has_value()) { return std::move(*value); }
+					return std::move(*state->value);
+				}
+			};
+
+			// `co_await future` (in a `Task`), the value is consumed like `then` does.
+			auto operator co_await() && -> awaiter
+			{
+				assert(valid() && "Invalid future!");
+				assert(!state_->continuation && "Only one continuation is allowed!");
+				return {std::move(state_), std::nullopt};
+			}
+		};
+
+		template<typename T>
+		class Promise
+		{
+		public:
+			using value_type  = T;
+			using future_type = Future<value_type>;
+			using state_type  = typename future_type::state_type;
+
+		private:
+			std::shared_ptr<state_type> state_;
+
+		public:
+			Promise()
+				: state_{std::make_shared<state_type>()} {}
+
+			[[nodiscard]] auto get_future() const -> future_type { return future_type{state_}; }
+
+			auto set_value(value_type&& value) -> void
+			{
+				assert(state_ && "Invalid promise!");
+				assert(!state_->value.has_value() && "The value has already been set!");
+
+				if (state_->continuation)
+				{
+					auto continuation = std::exchange(state_->continuation, {});
+					continuation(std::move(value));
+				}
+				else { state_->value.emplace(std::move(value)); }
+			}
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
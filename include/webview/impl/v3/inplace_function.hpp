@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		template<typename Signature, std::size_t Capacity = 64>
+		class InplaceFunction;
+
+		// A move-only `std::function` which never allocates: the callable is stored in the object itself,
+		// one which does not fit in `Capacity` bytes (or which may throw when it is moved) does not compile.
+		template<typename R, typename... Args, std::size_t Capacity>
+		class InplaceFunction<R(Args...), Capacity>
+		{
+		public:
+			using result_type = R;
+
+			constexpr static auto capacity = Capacity;
+
+		private:
+			struct vtable_type
+			{
+				R (*invoke)(void* callable, Args&&... args);
+				// move constructs `to` and destroys `from`
+				void (*relocate)(void* to, void* from) noexcept;
+				void (*destroy)(void* callable) noexcept;
+			};
+
+			template<typename Callable>
+			constexpr static vtable_type vtable_of{
+					.invoke = [](void* callable, Args&&... args) -> R { return std::invoke(*static_cast<Callable*>(callable), std::forward<Args>(args)...); },
+					.relocate = [](void* to, void* from) noexcept -> void
+					{
+						::new (to) Callable{std::move(*static_cast<Callable*>(from))};
+						static_cast<Callable*>(from)->~Callable();
+					},
+					.destroy = [](void* callable) noexcept -> void { static_cast<Callable*>(callable)->~Callable(); }};
+
+			alignas(std::max_align_t) std::byte storage_[Capacity];
+			const vtable_type* vtable_;
+
+			auto reset() noexcept -> void
+			{
+				if (vtable_) { std::exchange(vtable_, nullptr)->destroy(storage_); }
+			}
+
+		public:
+			constexpr InplaceFunction() noexcept
+				: storage_{},
+				  vtable_{nullptr} {}
+
+			constexpr InplaceFunction(std::nullptr_t) noexcept// NOLINT(google-explicit-constructor)
+				: InplaceFunction{} {}
+
+			template<typename Function>
+				requires(!std::is_same_v<std::remove_cvref_t<Function>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<Function>&, Args...>)
+			InplaceFunction(Function&& function)// NOLINT(google-explicit-constructor)
+				: vtable_{&vtable_of<std::decay_t<Function>>}
+			{
+				using callable_type = std::decay_t<Function>;
+
+				static_assert(sizeof(callable_type) <= Capacity, "The callable does not fit, increase the capacity!");
+				static_assert(alignof(callable_type) <= alignof(std::max_align_t), "Over-aligned callable!");
+				static_assert(std::is_nothrow_move_constructible_v<callable_type>, "The callable must not throw when it is moved!");
+
+				::new (static_cast<void*>(storage_)) callable_type{std::forward<Function>(function)};
+			}
+
+			InplaceFunction(const InplaceFunction&)                    = delete;
+			auto operator=(const InplaceFunction&) -> InplaceFunction& = delete;
+
+			InplaceFunction(InplaceFunction&& other) noexcept
+				: vtable_{std::exchange(other.vtable_, nullptr)}
+			{
+				if (vtable_) { vtable_->relocate(storage_, other.storage_); }
+			}
+
+			auto operator=(InplaceFunction&& other) noexcept -> InplaceFunction&
+			{
+				if (this != &other)
+				{
+					reset();
+					vtable_ = std::exchange(other.vtable_, nullptr);
+					if (vtable_) { vtable_->relocate(storage_, other.storage_); }
+				}
+				return *this;
+			}
+
+			auto operator=(std::nullptr_t) noexcept -> InplaceFunction&
+			{
+				reset();
+				return *this;
+			}
+
+			~InplaceFunction() noexcept { reset(); }
+
+			[[nodiscard]] explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+			// Like `std::function`, the callable is invoked as a non-const object.
+			auto operator()(Args... args) const -> R
+			{
+				assert(vtable_ && "Empty function!");
+				return vtable_->invoke(const_cast<std::byte*>(storage_), std::forward<Args>(args)...);
+			}
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,424 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <system_error>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <webview/impl/v3/string_scan.hpp>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		namespace json
+		{
+			// A value that is already serialized, it is written as is.
+			struct Raw
+			{
+				std::string_view value;
+			};
+
+			// Write a quoted string, the result is a valid JSON string and a valid javascript string literal
+			// (U+2028 and U+2029 are escaped too, they are not allowed to appear unescaped in javascript source code).
+			// The runs of bytes which do not have to be escaped are found by `string_scan` (SIMD if available) and copied at once.
+			template<typename String>
+			auto append_string(String& out, const std::string_view string) -> void
+			{
+				constexpr char hex[]{"0123456789abcdef"};
+
+				// most strings have (almost) nothing to escape
+				out.reserve(out.size() + string.size() + 2);
+				out.push_back('"');
+
+				auto* const end  = string.data() + string.size();
+				auto*       last = string.data();
+				for (auto* current = string_scan::find_json_special(last, end); current != end; current = string_scan::find_json_special(current, end))
+				{
+					const auto c = static_cast<unsigned char>(*current);
+
+					if (c == 0xe2)
+					{
+						// E2 80 A8 => U+2028, E2 80 A9 => U+2029
+						if (end - current >= 3 && static_cast<unsigned char>(current[1]) == 0x80 && (static_cast<unsigned char>(current[2]) & 0xfe) == 0xa8)
+						{
+							out.append(last, current);
+							out.append(static_cast<unsigned char>(current[2]) == 0xa8 ? "\\u2028" : "\\u2029");
+							current += 3;
+							last = current;
+						}
+						// any other character starting with E2
+						else { ++current; }
+						continue;
+					}
+
+					out.append(last, current);
+					switch (c)
+					{
+						case '"': out.append("\\\""); break;
+						case '\\': out.append("\\\\"); break;
+						case '\b': out.append("\\b"); break;
+						case '\f': out.append("\\f"); break;
+						case '\n': out.append("\\n"); break;
+						case '\r': out.append("\\r"); break;
+						case '\t': out.append("\\t"); break;
+						default:
+						{
+							const char escaped[]{'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+							out.append(escaped, sizeof(escaped));
+							break;
+						}
+					}
+					++current;
+					last = current;
+				}
+				out.append(last, end);
+
+				out.push_back('"');
+			}
+
+			template<typename String>
+			auto append(String& out, std::nullptr_t) -> void { out.append("null"); }
+
+			template<typename String>
+			auto append(String& out, const Raw raw) -> void { out.append(raw.value); }
+
+			template<typename String>
+			auto append(String& out, const std::string_view string) -> void { append_string(out, string); }
+
+			template<typename String>
+			auto append(String& out, const char* string) -> void { append_string(out, string); }
+
+			template<typename String, typename Allocator>
+			auto append(String& out, const std::basic_string<char, std::char_traits<char>, Allocator>& string) -> void { append_string(out, string); }
+
+			template<typename String>
+			auto append(String& out, const bool value) -> void { out.append(value ? "true" : "false"); }
+
+			template<typename String, typename T>
+				requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+			auto append(String& out, const T value) -> void
+			{
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					// JSON has no representation for them
+					if (!std::isfinite(value))
+					{
+						out.append("null");
+						return;
+					}
+				}
+
+				char buffer[32];
+				const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+				out.append(buffer, ptr);
+			}
+
+			template<typename String, typename T>
+			auto append(String& out, const std::optional<T>& value) -> void;
+
+			template<typename String, typename T, typename Allocator>
+			auto append(String& out, const std::vector<T, Allocator>& values) -> void
+			{
+				out.push_back('[');
+				for (std::size_t i = 0; i < values.size(); ++i)
+				{
+					if (i != 0) { out.push_back(','); }
+					append(out, values[i]);
+				}
+				out.push_back(']');
+			}
+
+			template<typename String, typename T>
+			auto append(String& out, const std::optional<T>& value) -> void
+			{
+				if (value.has_value()) { append(out, *value); }
+				else { out.append("null"); }
+			}
+
+			// std::vector / std::optional of anything can be appended, but only a few of them can be written
+			template<typename T>
+			struct is_writable : std::bool_constant<requires(std::string& out, const T& value) { json::append(out, value); }> {};
+
+			template<typename T, typename Allocator>
+			struct is_writable<std::vector<T, Allocator>> : is_writable<T> {};
+
+			template<typename T>
+			struct is_writable<std::optional<T>> : is_writable<T> {};
+
+			template<typename T>
+			concept writable = is_writable<T>::value;
+
+			// Read a quoted string from the front of the input (and remove it), the escapes are decoded into UTF-8.
+			// Returns false if the input does not start with a valid JSON string.
+			template<typename String>
+			[[nodiscard]] auto read_string(std::string_view& input, String& out) -> bool
+			{
+				const auto read_hex = [](const std::string_view hex, std::uint32_t& value) -> bool
+				{
+					if (hex.size() < 4) { return false; }
+					const auto [ptr, ec] = std::from_chars(hex.data(), hex.data() + 4, value, 16);
+					return ec == std::errc{} && ptr == hex.data() + 4;
+				};
+
+				const auto append_utf8 = [&out](const std::uint32_t code_point) -> void
+				{
+					if (code_point < 0x80) { out.push_back(static_cast<char>(code_point)); }
+					else if (code_point < 0x800)
+					{
+						out.push_back(static_cast<char>(0xc0 | code_point >> 6));
+						out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+					}
+					else if (code_point < 0x10000)
+					{
+						out.push_back(static_cast<char>(0xe0 | code_point >> 12));
+						out.push_back(static_cast<char>(0x80 | (code_point >> 6 & 0x3f)));
+						out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+					}
+					else
+					{
+						out.push_back(static_cast<char>(0xf0 | code_point >> 18));
+						out.push_back(static_cast<char>(0x80 | (code_point >> 12 & 0x3f)));
+						out.push_back(static_cast<char>(0x80 | (code_point >> 6 & 0x3f)));
+						out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+					}
+				};
+
+				if (!input.starts_with('"')) { return false; }
+
+				std::size_t current = 1;
+				std::size_t last    = 1;
+				while (current < input.size())
+				{
+					const auto c = input[current];
+					if (c == '"')
+					{
+						out.append(input.data() + last, input.data() + current);
+						input.remove_prefix(current + 1);
+						return true;
+					}
+					if (c != '\\')
+					{
+						++current;
+						continue;
+					}
+
+					out.append(input.data() + last, input.data() + current);
+					if (current + 1 >= input.size()) { return false; }
+					switch (input[current + 1])
+					{
+						case '"': out.push_back('"'); break;
+						case '\\': out.push_back('\\'); break;
+						case '/': out.push_back('/'); break;
+						case 'b': out.push_back('\b'); break;
+						case 'f': out.push_back('\f'); break;
+						case 'n': out.push_back('\n'); break;
+						case 'r': out.push_back('\r'); break;
+						case 't': out.push_back('\t'); break;
+						case 'u':
+						{
+							std::uint32_t code_point;
+							if (!read_hex(input.substr(current + 2), code_point)) { return false; }
+							current += 4;
+
+							// surrogate pair
+							if (code_point >= 0xd800 && code_point < 0xdc00)
+							{
+								std::uint32_t low;
+								if (input.substr(current + 2, 2) != "\\u" || !read_hex(input.substr(current + 4), low) || low < 0xdc00 || low >= 0xe000) { return false; }
+								code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+								current += 6;
+							}
+							append_utf8(code_point);
+							break;
+						}
+						default: return false;
+					}
+					current += 2;
+					last = current;
+				}
+				return false;
+			}
+
+			// A string read without copying it if it has no escape (it points into the input then), the buffer holds the decoded string otherwise.
+			struct InPlaceString
+			{
+				using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+				std::string_view value;
+				std::pmr::string buffer;
+
+				InPlaceString() = default;
+
+				explicit InPlaceString(const allocator_type& allocator)
+					: value{},
+					  buffer{allocator} {}
+			};
+
+			inline auto skip_whitespace(std::string_view& input) noexcept -> void
+			{
+				const auto begin = input.find_first_not_of(" \t\n\r");
+				input.remove_prefix(begin == std::string_view::npos ? input.size() : begin);
+			}
+
+			// Read a value from the front of the input (and remove it), leading whitespaces are skipped.
+			// Returns false if the input does not start with a value of the type.
+			template<typename T>
+			struct Reader;
+
+			template<typename T>
+			concept readable = requires(std::string_view& input, T& out) {
+				{ Reader<T>::read(input, out) } -> std::same_as<bool>;
+			};
+
+			template<>
+			struct Reader<bool>
+			{
+				[[nodiscard]] static auto read(std::string_view& input, bool& out) noexcept -> bool
+				{
+					skip_whitespace(input);
+					if (input.starts_with("true")) { out = true; }
+					else if (input.starts_with("false")) { out = false; }
+					else { return false; }
+
+					input.remove_prefix(out ? 4 : 5);
+					return true;
+				}
+			};
+
+			template<typename T>
+				requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+			struct Reader<T>
+			{
+				[[nodiscard]] static auto read(std::string_view& input, T& out) noexcept -> bool
+				{
+					skip_whitespace(input);
+					const auto [ptr, ec] = std::from_chars(input.data(), input.data() + input.size(), out);
+					if (ec != std::errc{} || ptr == input.data()) { return false; }
+
+					input.remove_prefix(static_cast<std::size_t>(ptr - input.data()));
+					return true;
+				}
+			};
+
+			template<typename Allocator>
+			struct Reader<std::basic_string<char, std::char_traits<char>, Allocator>>
+			{
+				[[nodiscard]] static auto read(std::string_view& input, std::basic_string<char, std::char_traits<char>, Allocator>& out) -> bool
+				{
+					skip_whitespace(input);
+					out.clear();
+					return read_string(input, out);
+				}
+			};
+
+			template<>
+			struct Reader<InPlaceString>
+			{
+				[[nodiscard]] static auto read(std::string_view& input, InPlaceString& out) -> bool
+				{
+					skip_whitespace(input);
+					if (!input.starts_with('"')) { return false; }
+
+					// the common case, nothing to decode
+					if (const auto end = input.find_first_of("\"\\", 1); end != std::string_view::npos && input[end] == '"')
+					{
+						out.value = input.substr(1, end - 1);
+						input.remove_prefix(end + 1);
+						return true;
+					}
+
+					out.buffer.clear();
+					if (!read_string(input, out.buffer)) { return false; }
+					out.value = out.buffer;
+					return true;
+				}
+			};
+
+			template<typename T>
+			struct Reader<std::optional<T>>
+			{
+				[[nodiscard]] static auto read(std::string_view& input, std::optional<T>& out) -> bool
+				{
+					skip_whitespace(input);
+					if (input.starts_with("null"))
+					{
+						input.remove_prefix(4);
+						out.reset();
+						return true;
+					}
+					return Reader<T>::read(input, out.emplace());
+				}
+			};
+
+			// The elements are constructed by the vector (with its allocator if they use one).
+			template<typename T, typename Allocator>
+			struct Reader<std::vector<T, Allocator>>
+			{
+				[[nodiscard]] static auto read(std::string_view& input, std::vector<T, Allocator>& out) -> bool
+				{
+					skip_whitespace(input);
+					if (!input.starts_with('[')) { return false; }
+					input.remove_prefix(1);
+
+					out.clear();
+					skip_whitespace(input);
+					if (input.starts_with(']'))
+					{
+						input.remove_prefix(1);
+						return true;
+					}
+
+					while (true)
+					{
+						if (!Reader<T>::read(input, out.emplace_back())) { return false; }
+
+						skip_whitespace(input);
+						if (input.starts_with(']'))
+						{
+							input.remove_prefix(1);
+							return true;
+						}
+						if (!input.starts_with(',')) { return false; }
+						input.remove_prefix(1);
+					}
+				}
+			};
+
+			// Read `[value0,value1,...]` (exactly that many values) into the outputs.
+			template<typename... Ts>
+			[[nodiscard]] auto read_array(std::string_view input, Ts&... out) -> bool
+			{
+				skip_whitespace(input);
+				if (!input.starts_with('[')) { return false; }
+				input.remove_prefix(1);
+
+				std::size_t index = 0;
+				const auto  read_one = [&input, &index]<typename T>(T& value) -> bool
+				{
+					if (index++ != 0)
+					{
+						skip_whitespace(input);
+						if (!input.starts_with(',')) { return false; }
+						input.remove_prefix(1);
+					}
+					return Reader<T>::read(input, value);
+				};
+				if (!(read_one(out) && ...)) { return false; }
+
+				skip_whitespace(input);
+				if (!input.starts_with(']')) { return false; }
+				input.remove_prefix(1);
+
+				skip_whitespace(input);
+				return input.empty();
+			}
+		}// namespace json
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// The counters and histograms of a web view (see `WebViewBase::metrics`), recorded with relaxed atomics so that a snapshot can be taken from any thread.
+		// Without `GAL_WEBVIEW_METRICS` (the CMake option of the same name) every metric is an empty object whose functions do nothing,
+		// the snapshots are all zeros.
+		namespace metrics
+		{
+			#if defined(GAL_WEBVIEW_METRICS)
+			constexpr bool enabled = true;
+			#else
+			constexpr bool enabled = false;
+			#endif
+
+			// Fixed buckets, log-linear like an HDR histogram: 8 buckets per power of two, so a value is known within 12.5%.
+			// Values up to 2^48 (more than 3 days in ns), larger ones are counted in the last bucket.
+			struct HistogramLayout
+			{
+				constexpr static std::size_t sub_bucket_bits  = 3;
+				constexpr static std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+				constexpr static std::size_t max_bits         = 48;
+				constexpr static std::size_t bucket_count     = sub_bucket_count + (max_bits - sub_bucket_bits) * sub_bucket_count;
+
+				[[nodiscard]] constexpr static auto index_of(const std::uint64_t value) noexcept -> std::size_t
+				{
+					if (value < sub_bucket_count) { return static_cast<std::size_t>(value); }
+
+					const auto width = static_cast<std::size_t>(std::bit_width(value));
+					if (width > max_bits) { return bucket_count - 1; }
+
+					// the bits right after the highest one
+					const auto sub_bucket = static_cast<std::size_t>(value >> (width - 1 - sub_bucket_bits)) & (sub_bucket_count - 1);
+					return sub_bucket_count + (width - 1 - sub_bucket_bits) * sub_bucket_count + sub_bucket;
+				}
+
+				[[nodiscard]] constexpr static auto lowest_of(const std::size_t index) noexcept -> std::uint64_t
+				{
+					if (index < sub_bucket_count) { return index; }
+
+					const auto shift      = (index - sub_bucket_count) / sub_bucket_count;
+					const auto sub_bucket = (index - sub_bucket_count) % sub_bucket_count;
+					return static_cast<std::uint64_t>(sub_bucket_count + sub_bucket) << shift;
+				}
+
+				// the highest value counted in the bucket
+				[[nodiscard]] constexpr static auto highest_of(const std::size_t index) noexcept -> std::uint64_t
+				{
+					if (index + 1 >= bucket_count) { return (std::uint64_t{1} << max_bits) - 1; }
+					return lowest_of(index + 1) - 1;
+				}
+			};
+
+			struct HistogramSnapshot
+			{
+				std::array<std::uint64_t, HistogramLayout::bucket_count> buckets;
+				std::uint64_t                                            count;
+				std::uint64_t                                            sum;
+
+				// The highest value of the bucket holding the quantile (0 <= q <= 1), 0 if nothing was recorded.
+				[[nodiscard]] constexpr auto quantile(const double q) const noexcept -> std::uint64_t
+				{
+					if (count == 0) { return 0; }
+
+					const auto    rank  = static_cast<std::uint64_t>(q * static_cast<double>(count) + 0.5);
+					std::uint64_t total = 0;
+					for (std::size_t i = 0; i < buckets.size(); ++i)
+					{
+						total += buckets[i];
+						if (total >= rank && total != 0) { return HistogramLayout::highest_of(i); }
+					}
+					return HistogramLayout::highest_of(buckets.size() - 1);
+				}
+
+				[[nodiscard]] constexpr auto mean() const noexcept -> double { return count == 0 ? 0 : static_cast<double>(sum) / static_cast<double>(count); }
+			};
+
+			#if defined(GAL_WEBVIEW_METRICS)
+
+			class Counter
+			{
+				std::atomic<std::uint64_t> value_{0};
+
+			public:
+				auto add(const std::uint64_t n = 1) noexcept -> void { value_.fetch_add(n, std::memory_order_relaxed); }
+
+				[[nodiscard]] auto value() const noexcept -> std::uint64_t { return value_.load(std::memory_order_relaxed); }
+			};
+
+			class Histogram
+			{
+				std::array<std::atomic<std::uint64_t>, HistogramLayout::bucket_count> buckets_{};
+				std::atomic<std::uint64_t>                                            sum_{0};
+
+			public:
+				auto record(const std::uint64_t value) noexcept -> void
+				{
+					buckets_[HistogramLayout::index_of(value)].fetch_add(1, std::memory_order_relaxed);
+					sum_.fetch_add(value, std::memory_order_relaxed);
+				}
+
+				[[nodiscard]] auto snapshot() const noexcept -> HistogramSnapshot
+				{
+					HistogramSnapshot snapshot{.buckets = {}, .count = 0, .sum = sum_.load(std::memory_order_relaxed)};
+					for (std::size_t i = 0; i < buckets_.size(); ++i)
+					{
+						snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+						snapshot.count += snapshot.buckets[i];
+					}
+					return snapshot;
+				}
+			};
+
+			// Measures a duration in nanoseconds.
+			class Stopwatch
+			{
+				std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+
+			public:
+				[[nodiscard]] auto elapsed() const noexcept -> std::uint64_t
+				{
+					return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+				}
+			};
+
+			#else
+
+			class Counter
+			{
+			public:
+				constexpr auto add([[maybe_unused]] const std::uint64_t n = 1) const noexcept -> void {}
+
+				[[nodiscard]] constexpr auto value() const noexcept -> std::uint64_t { return 0; }
+			};
+
+			class Histogram
+			{
+			public:
+				constexpr auto record([[maybe_unused]] const std::uint64_t value) const noexcept -> void {}
+
+				[[nodiscard]] constexpr auto snapshot() const noexcept -> HistogramSnapshot { return {.buckets = {}, .count = 0, .sum = 0}; }
+			};
+
+			class Stopwatch
+			{
+			public:
+				[[nodiscard]] constexpr auto elapsed() const noexcept -> std::uint64_t { return 0; }
+			};
+
+			#endif
+
+			// The durations are in nanoseconds.
+			struct Snapshot
+			{
+				std::uint64_t messages_received;
+				std::uint64_t bytes_received;
+				std::uint64_t messages_sent;
+				std::uint64_t bytes_sent;
+				std::uint64_t replies;
+				std::uint64_t evals;
+				std::uint64_t navigation_failures;
+
+				HistogramSnapshot eval_latency;
+				HistogramSnapshot handler_duration;
+				HistogramSnapshot worker_duration;
+				HistogramSnapshot dispatch_queue_depth;
+				HistogramSnapshot iteration_duration;
+				HistogramSnapshot navigation_commit;
+				HistogramSnapshot navigation_duration;
+			};
+
+			struct Registry
+			{
+				// messages posted by javascript (and their arguments)
+				Counter messages_received;
+				Counter bytes_received;
+				// scripts executed by the web view: the replies and the evals (one per batch)
+				Counter messages_sent;
+				Counter bytes_sent;
+				// calls settled (resolved or rejected)
+				Counter replies;
+				// scripts queued by `eval_async` (and the like)
+				Counter evals;
+				Counter navigation_failures;
+
+				// from the first script of a batch being queued to its result
+				Histogram eval_latency;
+				// the dispatch of one message on the loop thread
+				Histogram handler_duration;
+				// a call on a worker thread (`Execution::POOL` / `Execution::STRAND`)
+				Histogram worker_duration;
+				// the functions `dispatch`ed since the last iteration (when there are some)
+				Histogram dispatch_queue_depth;
+				// the work of the library itself in one turn of the loop (see `process_pending_work`)
+				Histogram iteration_duration;
+				// from the start of a navigation to its commit / to its end
+				Histogram navigation_commit;
+				Histogram navigation_duration;
+
+				[[nodiscard]] auto snapshot() const noexcept -> Snapshot
+				{
+					return {
+							.messages_received    = messages_received.value(),
+							.bytes_received       = bytes_received.value(),
+							.messages_sent        = messages_sent.value(),
+							.bytes_sent           = bytes_sent.value(),
+							.replies              = replies.value(),
+							.evals                = evals.value(),
+							.navigation_failures  = navigation_failures.value(),
+							.eval_latency         = eval_latency.snapshot(),
+							.handler_duration     = handler_duration.snapshot(),
+							.worker_duration      = worker_duration.snapshot(),
+							.dispatch_queue_depth = dispatch_queue_depth.snapshot(),
+							.iteration_duration   = iteration_duration.snapshot(),
+							.navigation_commit    = navigation_commit.snapshot(),
+							.navigation_duration  = navigation_duration.snapshot()};
+				}
+			};
+
+			namespace prometheus_detail
+			{
+				template<typename String>
+				auto append_number(String& out, const double value) -> void
+				{
+					char buffer[32];
+					const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+					out.append(buffer, ptr);
+				}
+
+				template<typename String>
+				auto append_header(String& out, const std::string_view prefix, const std::string_view name, const std::string_view type, const std::string_view help) -> void
+				{
+					out.append("# HELP ").append(prefix).append(name).push_back(' ');
+					out.append(help).push_back('\n');
+					out.append("# TYPE ").append(prefix).append(name).push_back(' ');
+					out.append(type).push_back('\n');
+				}
+
+				template<typename String>
+				auto append_counter(String& out, const std::string_view prefix, const std::string_view name, const std::string_view help, const std::uint64_t value) -> void
+				{
+					append_header(out, prefix, name, "counter", help);
+					out.append(prefix).append(name).push_back(' ');
+					append_number(out, static_cast<double>(value));
+					out.push_back('\n');
+				}
+
+				// A summary (the quantiles of the histogram), `scale` converts the values into the unit of the metric.
+				template<typename String>
+				auto append_summary(String& out, const std::string_view prefix, const std::string_view name, const std::string_view help, const HistogramSnapshot& histogram, const double scale) -> void
+				{
+					append_header(out, prefix, name, "summary", help);
+					for (const auto& [q, label]: {std::pair{0.5, "0.5"}, std::pair{0.9, "0.9"}, std::pair{0.99, "0.99"}, std::pair{0.999, "0.999"}})
+					{
+						out.append(prefix).append(name).append("{quantile=\"").append(label).append("\"} ");
+						append_number(out, static_cast<double>(histogram.quantile(q)) * scale);
+						out.push_back('\n');
+					}
+					out.append(prefix).append(name).append("_sum ");
+					append_number(out, static_cast<double>(histogram.sum) * scale);
+					out.push_back('\n');
+					out.append(prefix).append(name).append("_count ");
+					append_number(out, static_cast<double>(histogram.count));
+					out.push_back('\n');
+				}
+			}// namespace prometheus_detail
+
+			// The Prometheus text format, every name starts with `prefix` (which ends with '_'), the durations are in seconds.
+			template<typename String>
+			auto append_prometheus(String& out, const Snapshot& snapshot, const std::string_view prefix = "gal_webview_") -> void
+			{
+				using namespace prometheus_detail;
+
+				constexpr double seconds = 1e-9;
+
+				append_counter(out, prefix, "messages_received_total", "Messages posted by javascript.", snapshot.messages_received);
+				append_counter(out, prefix, "received_bytes_total", "Bytes posted by javascript.", snapshot.bytes_received);
+				append_counter(out, prefix, "messages_sent_total", "Scripts executed by the web view (replies and evals).", snapshot.messages_sent);
+				append_counter(out, prefix, "sent_bytes_total", "Bytes of the scripts executed by the web view.", snapshot.bytes_sent);
+				append_counter(out, prefix, "replies_total", "Calls settled.", snapshot.replies);
+				append_counter(out, prefix, "evals_total", "Scripts queued for evaluation.", snapshot.evals);
+				append_counter(out, prefix, "navigation_failures_total", "Navigations which failed.", snapshot.navigation_failures);
+
+				append_summary(out, prefix, "eval_latency_seconds", "From a script being queued to its result.", snapshot.eval_latency, seconds);
+				append_summary(out, prefix, "handler_duration_seconds", "Dispatch of a message on the loop thread.", snapshot.handler_duration, seconds);
+				append_summary(out, prefix, "worker_duration_seconds", "Call on a worker thread.", snapshot.worker_duration, seconds);
+				append_summary(out, prefix, "dispatch_queue_depth", "Functions dispatched to the loop thread per iteration.", snapshot.dispatch_queue_depth, 1);
+				append_summary(out, prefix, "iteration_duration_seconds", "Work of the library in one turn of the loop.", snapshot.iteration_duration, seconds);
+				append_summary(out, prefix, "navigation_commit_seconds", "From the start of a navigation to its commit.", snapshot.navigation_commit, seconds);
+				append_summary(out, prefix, "navigation_duration_seconds", "From the start of a navigation to its end.", snapshot.navigation_duration, seconds);
+			}
+
+			// Writes the file next to it then renames it, a reader (the textfile collector of the node exporter...) never sees a partial file.
+			inline auto write_prometheus(const std::filesystem::path& path, const Snapshot& snapshot, const std::string_view prefix = "gal_webview_") -> bool
+			{
+				std::string text{};
+				append_prometheus(text, snapshot, prefix);
+
+				auto temporary = path;
+				temporary += ".tmp";
+				{
+					std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+					if (!file.write(text.data(), static_cast<std::streamsize>(text.size()))) { return false; }
+				}
+
+				std::error_code error{};
+				std::filesystem::rename(temporary, path, error);
+				return !error;
+			}
+		}// namespace metrics
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// Multiple producers (any thread) / single consumer (the loop thread) queue.
+		// Producers push with a CAS on the head of a linked list, the consumer takes the whole list at once (so there is no ABA problem)
+		// and reverses it to get the items in FIFO order. Nobody ever blocks.
+		template<typename T>
+		class MpscQueue
+		{
+		public:
+			using value_type = T;
+
+		private:
+			struct node_type
+			{
+				value_type value;
+				node_type* next;
+			};
+
+			std::atomic<node_type*> head_;
+
+		public:
+			constexpr MpscQueue() noexcept
+				: head_{nullptr} {}
+
+			MpscQueue(const MpscQueue&)                    = delete;
+			MpscQueue(MpscQueue&&)                         = delete;
+			auto operator=(const MpscQueue&) -> MpscQueue& = delete;
+			auto operator=(MpscQueue&&) -> MpscQueue&      = delete;
+
+			~MpscQueue() noexcept
+			{
+				auto* node = head_.exchange(nullptr, std::memory_order_acquire);
+				while (node) { delete std::exchange(node, node->next); }
+			}
+
+			// Thread safe, returns true if the queue was empty (i.e. the consumer may have to be woken up).
+			auto push(value_type&& value) -> bool
+			{
+				auto* node = new node_type{std::move(value), nullptr};
+				auto* head = head_.load(std::memory_order_relaxed);
+				// the node may be consumed as soon as it is published, do not touch it after that
+				do { node->next = head; } while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+				return head == nullptr;
+			}
+
+			[[nodiscard]] auto empty() const noexcept -> bool { return head_.load(std::memory_order_relaxed) == nullptr; }
+
+			// Consumer only, invoke the function for every item pushed so far (in the order they were pushed).
+			// Items pushed during the drain are left for the next one.
+			template<typename Function>
+			auto drain(Function function) -> void
+			{
+				node_type* reversed = head_.exchange(nullptr, std::memory_order_acquire);
+
+				node_type* node = nullptr;
+				while (reversed) { node = std::exchange(reversed, std::exchange(reversed->next, node)); }
+
+				while (node)
+				{
+					function(std::move(node->value));
+					delete std::exchange(node, node->next);
+				}
+			}
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,97 @@
+#pragma once
+
+#if defined(GAL_WEBVIEW_PLATFORM_LINUX)
+
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// The memory of a process and of the WebKit processes it spawned (the web processes and the network process), read from /proc.
+		// With the sandbox of WebKit the WebKit processes are not its children but the children of bubblewrap, every descendant is counted.
+		namespace process_memory
+		{
+			namespace detail
+			{
+				[[nodiscard]] inline auto read_file(const std::filesystem::path& path) -> std::string
+				{
+					std::ifstream file{path};
+					return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+				}
+
+				// /proc/<pid>/stat: pid (comm) state ppid ..., 0 if it cannot be read
+				[[nodiscard]] inline auto parent_of(const std::filesystem::path& process) -> pid_t
+				{
+					const auto stat = read_file(process / "stat");
+
+					// the comm may contain anything, spaces and parentheses included
+					const auto comm_end = stat.rfind(')');
+					if (comm_end == std::string::npos || comm_end + 4 >= stat.size()) { return 0; }
+
+					pid_t parent = 0;
+					std::from_chars(stat.data() + comm_end + 4, stat.data() + stat.size(), parent);
+					return parent;
+				}
+			}// namespace detail
+
+			// KiB, 0 if the process does not exist ("self" is this process)
+			[[nodiscard]] inline auto resident_set_size(const std::string_view pid = "self") -> std::size_t
+			{
+				const auto statm = detail::read_file(std::filesystem::path{"/proc"} / pid / "statm");
+
+				// size resident shared ...
+				const auto resident_begin = statm.find(' ');
+				if (resident_begin == std::string::npos) { return 0; }
+
+				std::size_t pages = 0;
+				std::from_chars(statm.data() + resident_begin + 1, statm.data() + statm.size(), pages);
+				return pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+			}
+
+			// KiB, every process spawned by this one (and by them, and so on), this one excluded.
+			[[nodiscard]] inline auto descendants_resident_set_size() -> std::size_t
+			{
+				// pid, ppid
+				std::vector<std::pair<pid_t, pid_t>> processes{};
+				std::error_code                      ec;
+				for (const auto& entry: std::filesystem::directory_iterator{"/proc", ec})
+				{
+					const auto name = entry.path().filename().string();
+
+					pid_t pid = 0;
+					if (const auto [end, error] = std::from_chars(name.data(), name.data() + name.size(), pid); error != std::errc{} || end != name.data() + name.size()) { continue; }
+					processes.emplace_back(pid, detail::parent_of(entry.path()));
+				}
+
+				std::size_t        total = 0;
+				std::vector<pid_t> parents{getpid()};
+				while (!parents.empty())
+				{
+					const auto parent = parents.back();
+					parents.pop_back();
+
+					for (const auto& [pid, ppid]: processes)
+					{
+						if (ppid != parent) { continue; }
+
+						total += resident_set_size(std::to_string(pid));
+						parents.push_back(pid);
+					}
+				}
+				return total;
+			}
+		}// namespace process_memory
+	}
+}
+
+#endif
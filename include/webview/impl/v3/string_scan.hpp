@@ -0,0 +1,107 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GAL_WEBVIEW_STRING_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GAL_WEBVIEW_STRING_SCAN_SSE2
+#endif
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		namespace string_scan
+		{
+			// The bytes a JSON string / javascript string literal cannot contain as is:
+			// control characters, '"', '\\' and 0xE2 (the first byte of U+2028 / U+2029, the caller checks the next two bytes).
+			[[nodiscard]] constexpr auto is_json_special(const unsigned char c) noexcept -> bool { return c < 0x20 || c == '"' || c == '\\' || c == 0xe2; }
+
+			[[nodiscard]] inline auto find_json_special_scalar(const char* begin, const char* const end) noexcept -> const char*
+			{
+				while (begin != end && !is_json_special(static_cast<unsigned char>(*begin))) { ++begin; }
+				return begin;
+			}
+
+			#if defined(GAL_WEBVIEW_STRING_SCAN_AVX2)
+
+			[[nodiscard]] inline auto find_json_special(const char* begin, const char* const end) noexcept -> const char*
+			{
+				const auto quote     = _mm256_set1_epi8('"');
+				const auto backslash = _mm256_set1_epi8('\\');
+				const auto e2        = _mm256_set1_epi8(static_cast<char>(0xe2));
+				// c < 0x20 <=> max(c, 0x1f) == 0x1f (unsigned)
+				const auto control = _mm256_set1_epi8(0x1f);
+
+				for (; end - begin >= 32; begin += 32)
+				{
+					const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+					const auto special = _mm256_or_si256(
+							_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+							_mm256_or_si256(_mm256_cmpeq_epi8(chunk, e2), _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control)));
+
+					if (const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(special)); mask != 0) { return begin + std::countr_zero(mask); }
+				}
+				return find_json_special_scalar(begin, end);
+			}
+
+			#elif defined(GAL_WEBVIEW_STRING_SCAN_SSE2)
+
+			[[nodiscard]] inline auto find_json_special(const char* begin, const char* const end) noexcept -> const char*
+			{
+				const auto quote     = _mm_set1_epi8('"');
+				const auto backslash = _mm_set1_epi8('\\');
+				const auto e2        = _mm_set1_epi8(static_cast<char>(0xe2));
+				// c < 0x20 <=> max(c, 0x1f) == 0x1f (unsigned)
+				const auto control = _mm_set1_epi8(0x1f);
+
+				for (; end - begin >= 16; begin += 16)
+				{
+					const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+					const auto special = _mm_or_si128(
+							_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+							_mm_or_si128(_mm_cmpeq_epi8(chunk, e2), _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control)));
+
+					if (const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(special)); mask != 0) { return begin + std::countr_zero(mask); }
+				}
+				return find_json_special_scalar(begin, end);
+			}
+
+			#else
+
+			// 8 bytes at a time (SWAR)
+			[[nodiscard]] inline auto find_json_special(const char* begin, const char* const end) noexcept -> const char*
+			{
+				constexpr std::uint64_t ones = 0x0101010101010101;
+				constexpr std::uint64_t high = 0x8080808080808080;
+
+				// the high bit of every byte which is zero (exact for the first one, which is all we need)
+				constexpr auto has_zero = [](const std::uint64_t v) noexcept -> std::uint64_t { return (v - ones) & ~v & high; };
+
+				for (; end - begin >= 8; begin += 8)
+				{
+					std::uint64_t chunk;
+					std::memcpy(&chunk, begin, sizeof(chunk));
+
+					// a byte < 0x20 becomes < 0 after subtracting 0x20 (borrows only go through bytes that are < 0x20 already)
+					const auto control = (chunk - ones * 0x20) & ~chunk & high;
+					if (control | has_zero(chunk ^ (ones * '"')) | has_zero(chunk ^ (ones * '\\')) | has_zero(chunk ^ (ones * 0xe2)))
+					{
+						// somewhere in these 8 bytes
+						return find_json_special_scalar(begin, end);
+					}
+				}
+				return find_json_special_scalar(begin, end);
+			}
+
+			#endif
+		}// namespace string_scan
+	}// namespace v3
+}// namespace gal::web_view::impl
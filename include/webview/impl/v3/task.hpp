@@ -0,0 +1,206 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		template<typename T = void>
+		class Task;
+
+		namespace task_detail
+		{
+			template<typename T>
+			struct IsTask : std::false_type
+			{
+				using value_type = T;
+			};
+
+			template<typename T>
+			struct IsTask<Task<T>> : std::true_type
+			{
+				using value_type = T;
+			};
+
+			// Resumes whoever awaits the task once it completes (symmetric transfer, the stack does not grow).
+			struct FinalAwaiter
+			{
+				[[nodiscard]] constexpr auto await_ready() const noexcept -> bool { return false; }
+
+				template<typename Promise>
+				[[nodiscard]] auto await_suspend(const std::coroutine_handle<Promise> handle) const noexcept -> std::coroutine_handle<>
+				{
+					if (const auto continuation = handle.promise().continuation) { return continuation; }
+					return std::noop_coroutine();
+				}
+
+				constexpr auto await_resume() const noexcept -> void {}
+			};
+
+			struct PromiseBase
+			{
+				std::coroutine_handle<> continuation;
+				std::exception_ptr      exception;
+
+				[[nodiscard]] constexpr auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+				[[nodiscard]] constexpr auto final_suspend() const noexcept -> FinalAwaiter { return {}; }
+
+				auto unhandled_exception() noexcept -> void { exception = std::current_exception(); }
+			};
+
+			template<typename T>
+			struct Promise : PromiseBase
+			{
+				std::optional<T> value;
+
+				[[nodiscard]] auto get_return_object() noexcept -> Task<T>;
+
+				template<typename U>
+					requires std::is_constructible_v<T, U&&>
+				auto return_value(U&& v) -> void { value.emplace(std::forward<U>(v)); }
+
+				[[nodiscard]] auto result() -> T
+				{
+					if (exception) { std::rethrow_exception(exception); }
+					assert(value.has_value() && "The task has not completed!");
+					return std::move(*value);
+				}
+			};
+
+			template<>
+			struct Promise<void> : PromiseBase
+			{
+				[[nodiscard]] auto get_return_object() noexcept -> Task<void>;
+
+				constexpr auto return_void() const noexcept -> void {}
+
+				auto result() const -> void
+				{
+					if (exception) { std::rethrow_exception(exception); }
+				}
+			};
+
+			// Started as soon as it is created, destroyed as soon as it completes, nobody waits for it.
+			struct Detached
+			{
+				struct promise_type
+				{
+					[[nodiscard]] constexpr auto get_return_object() const noexcept -> Detached { return {}; }
+
+					[[nodiscard]] constexpr auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+
+					[[nodiscard]] constexpr auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+
+					constexpr auto return_void() const noexcept -> void {}
+
+					// like an exception escaping a thread
+					[[noreturn]] auto unhandled_exception() const noexcept -> void { std::terminate(); }
+				};
+			};
+		}// namespace task_detail
+
+		template<typename T>
+		constexpr auto is_task_v = task_detail::IsTask<T>::value;
+
+		// T for Task<T>, T itself otherwise
+		template<typename T>
+		using task_value_t = typename task_detail::IsTask<T>::value_type;
+
+		// A coroutine returning a value (or nothing), it starts when it is awaited (or `spawn`ed):
+		//	auto load(WebView& web_view) -> Task<std::string>
+		//	{
+		//		const auto navigation = co_await web_view.navigate_async("https://example.com");
+		//		const auto title      = co_await web_view.eval_async("document.title");
+		//		co_return title.value;
+		//	}
+		// There is no scheduler, a task is resumed wherever what it awaits completes (the loop thread for everything the web view returns).
+		template<typename T>
+		class [[nodiscard]] Task
+		{
+		public:
+			using value_type   = T;
+			using promise_type = task_detail::Promise<value_type>;
+			using handle_type  = std::coroutine_handle<promise_type>;
+
+		private:
+			handle_type handle_;
+
+		public:
+			explicit Task(const handle_type handle) noexcept
+				: handle_{handle} {}
+
+			Task(const Task&)                    = delete;
+			auto operator=(const Task&) -> Task& = delete;
+
+			Task(Task&& other) noexcept
+				: handle_{std::exchange(other.handle_, {})} {}
+
+			auto operator=(Task&& other) noexcept -> Task&
+			{
+				if (this != &other)
+				{
+					if (handle_) { handle_.destroy(); }
+					handle_ = std::exchange(other.handle_, {});
+				}
+				return *this;
+			}
+
+			~Task() noexcept
+			{
+				if (handle_) { handle_.destroy(); }
+			}
+
+			[[nodiscard]] auto valid() const noexcept -> bool { return static_cast<bool>(handle_); }
+
+			[[nodiscard]] auto done() const noexcept -> bool { return handle_ && handle_.done(); }
+
+			struct awaiter
+			{
+				handle_type handle;
+
+				[[nodiscard]] auto await_ready() const noexcept -> bool { return handle.done(); }
+
+				// start the task, it resumes the awaiting coroutine once it completes
+				[[nodiscard]] auto await_suspend(const std::coroutine_handle<> awaiting) const noexcept -> std::coroutine_handle<>
+				{
+					handle.promise().continuation = awaiting;
+					return handle;
+				}
+
+				auto await_resume() const -> value_type { return handle.promise().result(); }
+			};
+
+			auto operator co_await() && noexcept -> awaiter
+			{
+				assert(valid() && "Invalid task!");
+				return {handle_};
+			}
+		};
+
+		namespace task_detail
+		{
+			template<typename T>
+			auto Promise<T>::get_return_object() noexcept -> Task<T> { return Task<T>{std::coroutine_handle<Promise>::from_promise(*this)}; }
+
+			inline auto Promise<void>::get_return_object() noexcept -> Task<void> { return Task<void>{std::coroutine_handle<Promise>::from_promise(*this)}; }
+
+			template<typename T>
+			auto run(Task<T> task) -> Detached
+			{
+				co_await std::move(task);
+			}
+		}// namespace task_detail
+
+		// Starts the task and lets it run on its own (it is destroyed once it completes), an exception escaping it terminates the program.
+		// A task waiting for something that never comes (an eval of a web view which has been destroyed...) is never resumed, nor destroyed.
+		template<typename T>
+		auto spawn(Task<T>&& task) -> void { task_detail::run(std::move(task)); }
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// A fixed number of threads, each one has its own queue: a task is pushed to one of them (round robin, or the queue of the
+		// submitting worker), a worker takes its own tasks in order and steals from the others when it has nothing to do.
+		// The number of tasks waiting to be run is bounded, `try_submit` fails once it is reached (the caller decides what to do).
+		class ThreadPool
+		{
+		public:
+			using size_type = std::size_t;
+			using task_type = std::function<auto() -> void>;
+
+			class Strand;
+
+		private:
+			struct worker_type
+			{
+				std::mutex            mutex;
+				std::deque<task_type> tasks;
+			};
+
+			std::vector<std::unique_ptr<worker_type>> workers_;
+			std::vector<std::thread>                  threads_;
+
+			size_type capacity_;
+			// queued, not running
+			std::atomic<size_type> pending_;
+			std::atomic<size_type> next_worker_;
+
+			std::mutex              sleep_mutex_;
+			std::condition_variable sleep_;
+			std::atomic<size_type>  sleeping_;
+			std::atomic<bool>       stopping_;
+
+			// the worker running on this thread (if any), its own tasks go to its own queue
+			[[nodiscard]] static auto current_worker() noexcept -> worker_type*&
+			{
+				thread_local worker_type* worker = nullptr;
+				return worker;
+			}
+
+			// Ignores the capacity.
+			auto submit(task_type&& task) -> void
+			{
+				pending_.fetch_add(1);
+
+				auto* worker = current_worker();
+				if (!worker || std::ranges::none_of(workers_, [worker](const auto& w) { return w.get() == worker; }))
+				{
+					worker = workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()].get();
+				}
+
+				{
+					std::scoped_lock lock{worker->mutex};
+					worker->tasks.push_back(std::move(task));
+				}
+
+				// a worker increments `sleeping_` before it checks `pending_`, one of them sees the other
+				if (sleeping_.load() != 0)
+				{
+					{ std::scoped_lock lock{sleep_mutex_}; }
+					sleep_.notify_one();
+				}
+			}
+
+			// The oldest task of its own queue, or the newest task of another one.
+			[[nodiscard]] auto take(const size_type index, task_type& task) -> bool
+			{
+				{
+					auto& self = *workers_[index];
+					std::scoped_lock lock{self.mutex};
+					if (!self.tasks.empty())
+					{
+						task = std::move(self.tasks.front());
+						self.tasks.pop_front();
+						return true;
+					}
+				}
+
+				for (size_type i = 1; i < workers_.size(); ++i)
+				{
+					auto& victim = *workers_[(index + i) % workers_.size()];
+					std::scoped_lock lock{victim.mutex};
+					if (!victim.tasks.empty())
+					{
+						task = std::move(victim.tasks.back());
+						victim.tasks.pop_back();
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			auto work(const size_type index) -> void
+			{
+				current_worker() = workers_[index].get();
+
+				while (!stopping_.load(std::memory_order_relaxed))
+				{
+					if (task_type task{}; take(index, task))
+					{
+						pending_.fetch_sub(1, std::memory_order_relaxed);
+						task();
+						continue;
+					}
+
+					std::unique_lock lock{sleep_mutex_};
+					sleeping_.fetch_add(1);
+					sleep_.wait(lock, [this] { return stopping_.load(std::memory_order_relaxed) || pending_.load() != 0; });
+					sleeping_.fetch_sub(1);
+				}
+			}
+
+		public:
+			constexpr static size_type default_capacity{1024};
+
+			// 0 thread: one per core but one (the loop thread has its own)
+			explicit ThreadPool(size_type threads = 0, const size_type capacity = default_capacity)
+				: capacity_{capacity},
+				  pending_{0},
+				  next_worker_{0},
+				  sleeping_{0},
+				  stopping_{false}
+			{
+				if (threads == 0) { threads = std::max(std::thread::hardware_concurrency(), 2u) - 1; }
+
+				workers_.reserve(threads);
+				for (size_type i = 0; i < threads; ++i) { workers_.push_back(std::make_unique<worker_type>()); }
+
+				threads_.reserve(threads);
+				for (size_type i = 0; i < threads; ++i) { threads_.emplace_back([this, i] { work(i); }); }
+			}
+
+			ThreadPool(const ThreadPool&)                    = delete;
+			ThreadPool(ThreadPool&&)                         = delete;
+			auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+			auto operator=(ThreadPool&&) -> ThreadPool&      = delete;
+
+			~ThreadPool() noexcept { stop(); }
+
+			// Waits for the running tasks, the queued ones are dropped.
+			auto stop() noexcept -> void
+			{
+				{
+					std::scoped_lock lock{sleep_mutex_};
+					stopping_.store(true, std::memory_order_relaxed);
+				}
+				sleep_.notify_all();
+
+				for (auto& thread: threads_)
+				{
+					if (thread.joinable()) { thread.join(); }
+				}
+			}
+
+			[[nodiscard]] auto threads() const noexcept -> size_type { return threads_.size(); }
+
+			[[nodiscard]] auto capacity() const noexcept -> size_type { return capacity_; }
+
+			[[nodiscard]] auto pending() const noexcept -> size_type { return pending_.load(std::memory_order_relaxed); }
+
+			// Thread safe, returns false if `capacity()` tasks are already waiting (the task is not queued).
+			auto try_submit(task_type&& task) -> bool
+			{
+				if (stopping_.load(std::memory_order_relaxed) || pending() >= capacity_) { return false; }
+
+				submit(std::move(task));
+				return true;
+			}
+		};
+
+		// Runs its tasks on the pool one at a time, in the order they were posted (at most one task of the strand is in the pool).
+		class ThreadPool::Strand : public std::enable_shared_from_this<Strand>
+		{
+		public:
+			using size_type = ThreadPool::size_type;
+			using task_type = ThreadPool::task_type;
+
+		private:
+			ThreadPool&           pool_;
+			std::mutex            mutex_;
+			std::deque<task_type> tasks_;
+			bool                  scheduled_;
+
+			auto drain() -> void
+			{
+				for (;;)
+				{
+					task_type task{};
+					{
+						std::scoped_lock lock{mutex_};
+						if (tasks_.empty())
+						{
+							scheduled_ = false;
+							return;
+						}
+						task = std::move(tasks_.front());
+						tasks_.pop_front();
+					}
+					task();
+				}
+			}
+
+		public:
+			explicit Strand(ThreadPool& pool)
+				: pool_{pool},
+				  scheduled_{false} {}
+
+			// Thread safe, returns false if `capacity()` tasks of the strand are already waiting (the task is not queued).
+			auto try_post(task_type&& task) -> bool
+			{
+				{
+					std::scoped_lock lock{mutex_};
+					if (pool_.stopping_.load(std::memory_order_relaxed) || tasks_.size() >= pool_.capacity()) { return false; }
+
+					tasks_.push_back(std::move(task));
+					if (std::exchange(scheduled_, true)) { return true; }
+				}
+
+				// the strand keeps itself alive until it is drained
+				pool_.submit([self = shared_from_this()] { self->drain(); });
+				return true;
+			}
+		};
+	}// namespace v3
+}// namespace gal::web_view::impl
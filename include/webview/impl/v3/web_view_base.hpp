@@ -1,9 +1,34 @@
 #pragma once
 
 #include <type_traits>
+#include <algorithm>
 #include <string>
 #include <string_view>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <charconv>
+#include <chrono>
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <webview/impl/v3/asset.hpp>
+#include <webview/impl/v3/base64.hpp>
+#include <webview/impl/v3/binding_table.hpp>
+#include <webview/impl/v3/function_traits.hpp>
+#include <webview/impl/v3/future.hpp>
+#include <webview/impl/v3/inplace_function.hpp>
+#include <webview/impl/v3/json.hpp>
+#include <webview/impl/v3/metrics.hpp>
+#include <webview/impl/v3/mpsc_queue.hpp>
+#include <webview/impl/v3/task.hpp>
+#include <webview/impl/v3/thread_pool.hpp>
 
 namespace gal::web_view
 {
@@ -35,11 +60,81 @@ namespace gal::web_view
 		NAVIGATE_FAILED,
 	};
 
+	// Evaluate javascript
+	enum class EvalResult : std::uint8_t
+	{
+		SUCCESS,
+
+		SERVICE_NOT_READY_YET,
+		EVAL_FAILED,
+	};
+
+	// The phases of a navigation, in order (REDIRECTED may happen several times, FAILED replaces the ones which did not happen)
+	enum class NavigationEvent : std::uint8_t
+	{
+		STARTED,
+		REDIRECTED,
+		// The first bytes of the document arrived
+		COMMITTED,
+		// The document and its resources have been loaded
+		FINISHED,
+		FAILED,
+		// The Navigation Timing of the finished document is available
+		TIMING,
+	};
+
+	// The frames an injected script / style sheet applies to
+	enum class InjectFrames : std::uint8_t
+	{
+		TOP_FRAME,
+		ALL_FRAMES,
+	};
+
+	// When an injected script runs (a style sheet applies as soon as the document exists)
+	enum class InjectTime : std::uint8_t
+	{
+		DOCUMENT_START,
+		DOCUMENT_END,
+	};
+
+	// Where a bound function runs
+	enum class Execution : std::uint8_t
+	{
+		// On the loop thread, while the message is dispatched
+		INLINE,
+		// On any of the worker threads, the calls run concurrently
+		POOL,
+		// On the worker threads, one call at a time in the order they arrived (per bound function)
+		STRAND,
+	};
+
+	// When the temporaries of the messages are released (see `message_resource`)
+	enum class ArenaReset : std::uint8_t
+	{
+		// Once the message has been dispatched
+		PER_MESSAGE,
+		// Once per `iteration()`, all the messages dispatched by one iteration share the arena
+		PER_ITERATION,
+	};
+
 	namespace impl
 	{
 		inline namespace v3
 		{
-			template<typename ImplType>
+			// The types a web view is built from (the default policy), an implementation can be given another one:
+			//	string_type: the strings it owns (std::string, std::pmr::string...), those allocated per message use an `allocator_type` given at construction
+			//	function_type<Signature>: the callbacks it stores (std::function, std::move_only_function, `InplaceFunction<Signature, N>` which never allocates...)
+			// A non-owning callable (function_ref) cannot be used, the handlers are wrapped into callables the web view owns.
+			struct WebViewTraits
+			{
+				using string_type    = std::string;
+				using allocator_type = string_type::allocator_type;
+
+				template<typename Signature>
+				using function_type = std::function<Signature>;
+			};
+
+			template<typename ImplType, typename Traits = WebViewTraits>
 			class WebViewBase
 			{
 				using impl_type = ImplType;
@@ -49,10 +144,75 @@ namespace gal::web_view
 				[[nodiscard]] constexpr auto rep() const & noexcept -> const impl_type& { return static_cast<const impl_type&>(*this); }
 
 			public:
+				using traits_type = Traits;
+
+				template<typename Signature>
+				using function_type = typename traits_type::template function_type<Signature>;
+
 				using window_size_type = int;
-				using string_type = std::string;
+				using string_type = typename traits_type::string_type;
+				using allocator_type = typename traits_type::allocator_type;
 				using string_view_type = std::string_view;
-				using javascript_callback_type = std::function<auto(impl_type& /* web_view */, string_type&& /* string */) -> void>;
+
+				// Every `window.external.<name>` returns a Promise, the call id is used to settle it (see `resolve` / `reject`).
+				using call_id_type = std::uint32_t;
+				// The string is borrowed from the underlying message, it is only valid during the call.
+				using rpc_callback_type = function_type<auto(impl_type& /* web_view */, call_id_type /* id */, string_view_type /* string */) -> void>;
+				// `Uint8Array` / `ArrayBuffer` (or any other `ArrayBuffer` view) arguments, the bytes are borrowed too.
+				using bytes_view_type      = std::span<const std::byte>;
+				using binary_callback_type = function_type<auto(impl_type& /* web_view */, call_id_type /* id */, bytes_view_type /* bytes */) -> void>;
+
+				// Invoked on the loop thread (see `dispatch`).
+				using dispatch_callback_type = function_type<auto(impl_type& /* web_view */) -> void>;
+
+				// The message was not posted by `window.external.<name>`, there is no one waiting for the reply.
+				constexpr static call_id_type invalid_call_id{0};
+
+				struct eval_result_type
+				{
+					EvalResult result;
+					// SUCCESS: the string value (or the JSON representation of a non-string value) of the script
+					// EVAL_FAILED: the error message
+					string_type value;
+				};
+
+				using eval_future_type  = Future<eval_result_type>;
+				using eval_promise_type = Promise<eval_result_type>;
+
+				// Scripts evaluated by `eval_async` are queued and executed as one script (each of them isolated by a try/catch) once per `iteration()`.
+				// In a batch a script is evaluated as an expression, its value is its result. A script which is not one (a statement, a `let`...)
+				// makes the whole batch invalid, nothing of it runs and every script of it is evaluated alone (like a script which is never batched).
+				// A function / class declaration or a block is an expression there: `function f(){}` does not declare `f`, `{a: 1}` is an object.
+				struct eval_batch_type
+				{
+					// The queue is flushed as soon as the scripts reach the size.
+					std::size_t max_bytes;
+					// How long a script may wait in the queue, 0 means that the queue is flushed on every `iteration()`.
+					std::chrono::milliseconds max_delay;
+				};
+
+				constexpr static eval_batch_type default_eval_batch{.max_bytes = 64 * 1024, .max_delay = std::chrono::milliseconds{0}};
+
+				// The threads running the functions bound with `Execution::POOL` / `Execution::STRAND`, they are created by the first of them.
+				struct worker_pool_type
+				{
+					// 0 means one per core but one
+					std::size_t threads;
+					// How many calls may wait for a thread (per strand for `Execution::STRAND`), the next ones are rejected.
+					std::size_t capacity;
+				};
+
+				constexpr static worker_pool_type default_worker_pool{.threads = 0, .capacity = ThreadPool::default_capacity};
+
+				// The arena in which the messages are decoded (see `message_resource`), a message which does not fit allocates the rest (until the reset).
+				struct message_arena_type
+				{
+					// bytes, allocated once
+					std::size_t size;
+					ArenaReset  reset;
+				};
+
+				constexpr static message_arena_type default_message_arena{.size = 16 * 1024, .reset = ArenaReset::PER_MESSAGE};
 
 				constexpr static window_size_type default_window_width{800};
 				constexpr static window_size_type default_window_height{600};
@@ -70,7 +230,86 @@ namespace gal::web_view
 							</body>
 							</html>)"};
 
+				constexpr static string_view_type reply_function_name{"window.external.__reply"};
+
+				using navigation_clock_type = std::chrono::steady_clock;
+
+				// The Navigation Timing (`performance.getEntriesByType('navigation')[0]`) of a document, in ms since the navigation started.
+				struct navigation_timing_type
+				{
+					double redirect_start;
+					double redirect_end;
+					double fetch_start;
+					double domain_lookup_start;
+					double domain_lookup_end;
+					double connect_start;
+					double connect_end;
+					double request_start;
+					double response_start;
+					double response_end;
+					double dom_interactive;
+					double dom_content_loaded_event_end;
+					double dom_complete;
+					double load_event_end;
+					// bytes (0 if the document came from the cache)
+					double transfer_size;
+					double decoded_body_size;
+				};
+
+				struct navigation_type
+				{
+					// 1 for the first navigation, then increasing
+					std::uint32_t id;
+					// the url of the document, it changes with every redirection
+					string_type url;
+					// `time_point{}` until the phase is reached, `finished` is set by FAILED too
+					navigation_clock_type::time_point started;
+					navigation_clock_type::time_point redirected;
+					navigation_clock_type::time_point committed;
+					navigation_clock_type::time_point finished;
+					// FAILED only
+					string_type error;
+					// TIMING only (fetched once per finished navigation)
+					std::optional<navigation_timing_type> timing;
+
+					[[nodiscard]] auto failed() const noexcept -> bool { return !error.empty(); }
+				};
+
+				// Settled once the navigation requested by `navigate_async` finished (or failed).
+				using navigation_future_type  = Future<navigation_type>;
+				using navigation_promise_type = Promise<navigation_type>;
+
+				// Invoked on the loop thread for every phase of every navigation (of the top frame).
+				using navigation_callback_type = function_type<auto(impl_type& /* web_view */, NavigationEvent /* event */, const navigation_type& /* navigation */) -> void>;
+
+				// See `metrics()`, everything is a no-op without `GAL_WEBVIEW_METRICS`.
+				using metrics_type          = metrics::Registry;
+				using metrics_snapshot_type = metrics::Snapshot;
+
+				// Every script / style sheet injected by `add_script` / `add_style_sheet` has an id (see `remove_injection`).
+				using injection_id_type = std::uint32_t;
+
+				constexpr static injection_id_type invalid_injection_id{0};
+
+				struct injection_type
+				{
+					injection_id_type id;
+					bool              style_sheet;
+					InjectFrames      frames;
+					InjectTime        time;
+					string_type       code;
+				};
+
 			protected:
+				// The strings allocated per message (and the buffers of the web view) use it.
+				allocator_type allocator_;
+				// The temporaries of the messages (loop thread only), released once no message is being dispatched (see `message_resource`).
+				message_arena_type                                  message_arena_;
+				std::pmr::vector<std::byte>                         message_buffer_;
+				std::optional<std::pmr::monotonic_buffer_resource> message_resource_;
+				// messages being dispatched (a handler may run the loop, `eval` for example)
+				std::uint32_t dispatching_;
+
 				window_size_type window_width_;
 				window_size_type window_height_;
 				string_type      window_title_;
@@ -80,9 +319,110 @@ namespace gal::web_view
 
 				ServiceStateResult service_state_;
 
-				string_type              current_url_;
-				javascript_callback_type current_callback_;
-				string_type              inject_javascript_code_;
+				// Only one of them is set, a binary argument is viewed as a string by a string handler and vice versa.
+				struct binding_type
+				{
+					rpc_callback_type    string_handler;
+					binary_callback_type binary_handler;
+				};
+
+				// `bind` / `unbind` called by a handler (which lives in the table), applied once the message has been dispatched.
+				struct binding_change_type
+				{
+					string_type                 name;
+					std::optional<binding_type> binding;
+				};
+
+				string_type                      current_url_;
+				BindingTable<binding_type>       bindings_;
+				std::vector<binding_change_type> binding_changes_;
+				// The current (or the last) navigation
+				navigation_type          navigation_;
+				navigation_callback_type navigation_callback_;
+				// `navigate_async`, settled by the first navigation whose id is at least this one
+				std::vector<std::pair<std::uint32_t, navigation_promise_type>> navigation_promises_;
+
+				// The bridge and the stubs of the bound functions, injected before anything else.
+				string_type inject_javascript_code_;
+				// The stubs in it (name, json arguments), one per name: unbinding a function keeps its stub, binding it again reuses it.
+				std::vector<std::pair<string_type, bool>> stubs_;
+				// Injected into every document in order, the implementation creates the native objects once and reuses them.
+				std::vector<injection_type> injections_;
+				injection_id_type           last_injection_id_;
+				// All replies settled since the last iteration, they are sent back in one script execution.
+				string_type reply_javascript_code_;
+				// The bytes transferred by the implementation (`do_resolve`), they split the replies into several scripts:
+				// `reply_offset` is the end of the script (in `reply_javascript_code_`) with the replies settled before them.
+				struct binary_reply_type
+				{
+					call_id_type           id;
+					std::size_t            reply_offset;
+					std::vector<std::byte> bytes;
+				};
+
+				std::vector<binary_reply_type> binary_replies_;
+				// The beginning of the script the next reply is appended to.
+				std::size_t reply_begin_;
+				eval_batch_type eval_batch_;
+				// Scripts queued since the last flush, concatenated (`eval_queue_ends_` splits them).
+				string_type                           eval_queue_code_;
+				std::vector<std::size_t>              eval_queue_ends_;
+				std::vector<eval_promise_type>        eval_queue_promises_;
+				std::chrono::steady_clock::time_point eval_queue_since_;
+				// The script actually executed, the buffer is reused.
+				string_type eval_batch_code_;
+				// The only members which are accessed by other threads (with `worker_replies_`).
+				MpscQueue<dispatch_callback_type> dispatch_queue_;
+				// Custom schemes, they are registered when the service starts.
+				std::vector<std::pair<string_type, const AssetRegistry*>> schemes_;
+
+				// A call executed by a worker thread, the reply is written by the worker and the loop thread only appends it to the others.
+				struct worker_reply_type
+				{
+					call_id_type id;
+					bool         success;
+					// the JSON value (or the reason)
+					string_type value;
+					// the bytes of a binary reply, if the implementation is given them as they are (see `transfers_bytes`)
+					std::optional<std::vector<std::byte>> binary;
+
+					auto resolve([[maybe_unused]] const call_id_type call_id) -> void
+					{
+						success = true;
+						value.assign("undefined");
+					}
+
+					template<typename T>
+						requires(!std::is_convertible_v<const T&, bytes_view_type>)
+					auto resolve([[maybe_unused]] const call_id_type call_id, const T& v) -> void
+					{
+						success = true;
+						json::append(value, v);
+					}
+
+					auto resolve([[maybe_unused]] const call_id_type call_id, const bytes_view_type bytes) -> void
+					{
+						success = true;
+						if constexpr (transfers_bytes()) { binary.emplace(bytes.begin(), bytes.end()); }
+						else { append_bytes(value, bytes); }
+					}
+
+					auto reject([[maybe_unused]] const call_id_type call_id, const string_view_type reason) -> void
+					{
+						success = false;
+						value.clear();
+						json::append(value, reason);
+					}
+				};
+
+				MpscQueue<worker_reply_type> worker_replies_;
+				// Recorded by the loop thread and the worker threads.
+				metrics_type                 metrics_;
+				worker_pool_type             worker_pool_;
+				// Shared with the continuations the engine may run once the web view is destroyed (see `end_lifetime`).
+				std::shared_ptr<const bool> lifetime_;
+				// Destroyed first, no worker outlives the rest (see `stop_workers`).
+				std::unique_ptr<ThreadPool> worker_threads_;
 
 				constexpr WebViewBase(
 						const window_size_type window_width,
@@ -91,15 +431,884 @@ namespace gal::web_view
 						const bool             window_is_fixed,
 						const bool             window_is_fullscreen,
 						const bool             web_view_use_dev_tools,
-						string_type&&          index_url)
-					: window_width_{window_width},
+						string_type&&          index_url,
+						const allocator_type&  allocator = {})
+					: allocator_{allocator},
+					  message_arena_{default_message_arena},
+					  message_buffer_{upstream_resource()},
+					  message_resource_{},
+					  dispatching_{0},
+					  window_width_{window_width},
 					  window_height_{window_height},
 					  window_title_{std::move(window_title)},
 					  window_is_fixed_{window_is_fixed},
 					  window_is_fullscreen_{window_is_fullscreen},
 					  web_view_use_dev_tools_{web_view_use_dev_tools},
 					  service_state_{ServiceStateResult::UNINITIALIZED},
-					  current_url_{std::move(index_url)} {}
+					  current_url_{std::move(index_url)},
+					  navigation_{
+							  .id         = 0,
+							  .url        = string_type{allocator},
+							  .started    = {},
+							  .redirected = {},
+							  .committed  = {},
+							  .finished   = {},
+							  .error      = string_type{allocator},
+							  .timing     = std::nullopt},
+					  inject_javascript_code_{bridge_javascript_code(), allocator},
+					  last_injection_id_{invalid_injection_id},
+					  reply_javascript_code_{allocator},
+					  reply_begin_{0},
+					  eval_batch_{default_eval_batch},
+					  eval_queue_code_{allocator},
+					  eval_batch_code_{allocator},
+					  worker_pool_{default_worker_pool},
+					  lifetime_{std::make_shared<const bool>(true)} { reset_message_arena(); }
+
+				// Where the arena gets its memory: the resource of the allocator of the web view if it has one.
+				[[nodiscard]] auto upstream_resource() const noexcept -> std::pmr::memory_resource*
+				{
+					if constexpr (requires { { allocator_.resource() } -> std::convertible_to<std::pmr::memory_resource*>; }) { return allocator_.resource(); }
+					else { return std::pmr::new_delete_resource(); }
+				}
+
+				auto reset_message_arena() -> void
+				{
+					message_resource_.reset();
+					message_buffer_.clear();
+					message_buffer_.shrink_to_fit();
+					if (message_arena_.size == 0)
+					{
+						message_resource_.emplace(upstream_resource());
+						return;
+					}
+					message_buffer_.resize(message_arena_.size);
+					message_resource_.emplace(message_buffer_.data(), message_buffer_.size(), upstream_resource());
+				}
+
+				// Releases the temporaries of the messages, unless one of them is still being dispatched.
+				auto release_message_resource() noexcept -> void
+				{
+					if (dispatching_ == 0) { message_resource_->release(); }
+				}
+
+				struct dispatch_scope
+				{
+					WebViewBase& web_view;
+
+					explicit dispatch_scope(WebViewBase& w) noexcept
+						: web_view{w} { ++web_view.dispatching_; }
+
+					dispatch_scope(const dispatch_scope&)                    = delete;
+					auto operator=(const dispatch_scope&) -> dispatch_scope& = delete;
+
+					~dispatch_scope() noexcept
+					{
+						--web_view.dispatching_;
+						if (web_view.message_arena_.reset == ArenaReset::PER_MESSAGE) { web_view.release_message_resource(); }
+					}
+				};
+
+				// Takes the changes which are not applied yet into account.
+				[[nodiscard]] auto is_bound(const string_view_type name) const noexcept -> bool
+				{
+					const auto it = std::ranges::find(binding_changes_ | std::views::reverse, name, &binding_change_type::name);
+					if (it != std::ranges::end(binding_changes_ | std::views::reverse)) { return it->binding.has_value(); }
+					return bindings_.find(name) != nullptr;
+				}
+
+				auto apply_binding_changes() -> void
+				{
+					if (dispatching_ != 0 || binding_changes_.empty()) { return; }
+
+					for (auto changes = std::exchange(binding_changes_, {});
+					     auto& [name, binding]: changes)
+					{
+						if (binding) { bindings_.insert(name, std::move(*binding)); }
+						else { bindings_.erase(name); }
+					}
+				}
+
+				// A string allocated with the allocator of the web view (loop thread only, the allocator may not be thread safe).
+				[[nodiscard]] auto make_string(const string_view_type string) const -> string_type { return string_type{string, allocator_}; }
+
+				// The implementation calls it first in its destructor, a running worker may still wake up the loop (`do_wake_up`).
+				auto stop_workers() noexcept -> void
+				{
+					if (worker_threads_) { worker_threads_->stop(); }
+				}
+
+				// The implementation calls it in its destructor too, the engine may still settle the scripts it has been given
+				// (their continuations settle the promises of the caller and leave the web view alone).
+				auto end_lifetime() noexcept -> void { lifetime_.reset(); }
+
+				[[nodiscard]] auto worker_threads() -> ThreadPool&
+				{
+					if (!worker_threads_) { worker_threads_ = std::make_unique<ThreadPool>(worker_pool_.threads, worker_pool_.capacity); }
+					return *worker_threads_;
+				}
+
+				// Creates the worker threads if the function runs on them, and its strand if it has one.
+				[[nodiscard]] auto prepare_execution(const Execution execution) -> std::shared_ptr<ThreadPool::Strand>
+				{
+					if (execution == Execution::INLINE) { return nullptr; }
+
+					auto& threads = worker_threads();
+					if (execution == Execution::POOL) { return nullptr; }
+					return std::make_shared<ThreadPool::Strand>(threads);
+				}
+
+				// The work writes the reply, which is sent back to the loop thread (a call beyond the capacity is rejected at once).
+				template<typename Work>
+				auto execute_on_workers(ThreadPool::Strand* strand, const call_id_type id, Work&& work) -> void
+				{
+					ThreadPool::task_type task{
+							[this, id, work = std::forward<Work>(work)]() mutable -> void
+							{
+								worker_reply_type reply{.id = id, .success = false, .value = {}, .binary = std::nullopt};
+								const metrics::Stopwatch stopwatch{};
+								work(reply);
+								metrics_.worker_duration.record(stopwatch.elapsed());
+								if (id == invalid_call_id) { return; }
+
+								// only the first reply since the last drain wakes up the loop, the others are drained with it
+								if (worker_replies_.push(std::move(reply))) { rep().do_wake_up(); }
+							}};
+
+					if (!(strand ? strand->try_post(std::move(task)) : worker_threads().try_submit(std::move(task)))) { reject(id, "too many pending calls"); }
+				}
+
+				// An exception escaping the function rejects the call.
+				template<typename Target, typename Function>
+				static auto settle_or_reject(Target& target, const call_id_type id, Function function) -> void
+				{
+					try { function(); }
+					catch (const std::exception& exception) { target.reject(id, exception.what()); }
+					catch (...) { target.reject(id, "unknown exception"); }
+				}
+
+				// Settles the call with the result of the handler.
+				template<typename Target, typename Handler, typename Argument>
+				static auto invoke_and_settle(Target& target, const call_id_type id, Handler& handler, Argument&& argument) -> void
+				{
+					using result_type = std::invoke_result_t<Handler&, Argument&&>;
+
+					static_assert(!is_task_v<result_type>, "A coroutine cannot run on the worker threads, bind it without an execution!");
+					static_assert(
+							std::is_void_v<result_type> || json::writable<std::remove_cvref_t<result_type>> || std::is_convertible_v<std::add_lvalue_reference_t<const result_type>, bytes_view_type>,
+							"Unsupported return type! (void, bool, number, string, json::Raw, bytes, std::optional / std::vector of them)");
+
+					settle_or_reject(
+							target,
+							id,
+							[&]() -> void
+							{
+								if constexpr (std::is_void_v<result_type>)
+								{
+									std::invoke(handler, std::forward<Argument>(argument));
+									target.resolve(id);
+								}
+								else { target.resolve(id, std::invoke(handler, std::forward<Argument>(argument))); }
+							});
+				}
+
+				// The javascript side of the bridge, `impl_type::post_message_function` sends a string to the native side.
+				// If the implementation provides `impl_type::post_binary_message_function`, binary arguments are sent as `[id, name, Uint8Array]`,
+				// otherwise they are sent as a base64 string (prefixed with `*`).
+				// `window.external.__bind(name)` generates the stub `window.external.<name>(arg)`.
+				// `window.external.__bind_json(name)` generates the stub `window.external.<name>(...args)`, the arguments are sent as a JSON array.
+				[[nodiscard]] static auto bridge_javascript_code() -> string_type
+				{
+					string_type code{
+							"window.external=(()=>{"
+							"const calls=new Map();"
+							"let id=0;"
+							"const call=(name,arg)=>new Promise((resolve,reject)=>{"
+							"id=id%4294967295+1;"
+							"calls.set(id,[resolve,reject]);"
+							"if(arg instanceof ArrayBuffer||ArrayBuffer.isView(arg)){"
+							"const bytes=arg instanceof Uint8Array?arg:ArrayBuffer.isView(arg)?new Uint8Array(arg.buffer,arg.byteOffset,arg.byteLength):new Uint8Array(arg);"};
+					if constexpr (requires { impl_type::post_binary_message_function; }) { code.append(impl_type::post_binary_message_function).append("([id,name,bytes]);"); }
+					else
+					{
+						code.append(
+								"let s='';"
+								"for(let i=0;i<bytes.length;i+=32768){s+=String.fromCharCode.apply(null,bytes.subarray(i,i+32768));}");
+						code.append(impl_type::post_message_function).append("('*'+id+':'+name+':'+btoa(s));");
+					}
+					code.append("}else{")
+							.append(impl_type::post_message_function)
+							.append(
+									"(id+':'+name+':'+arg);"
+									"}"
+									"});"
+									"return{"
+									"__bind:name=>{window.external[name]=arg=>call(name,arg);},"
+									"__bind_json:name=>{window.external[name]=(...args)=>call(name,JSON.stringify(args));},"
+									"__bytes:s=>Uint8Array.from(atob(s),c=>c.charCodeAt(0)),"
+									"__reply:replies=>{"
+									"for(const[id,ok,value]of replies){"
+									"const c=calls.get(id);"
+									"if(c){calls.delete(id);c[ok?0:1](value);}"
+									"}"
+									"}"
+									"};"
+									"})();");
+					code.append(bind_javascript_code(GAL_WEBVIEW_METHOD_NAME));
+					return code;
+				}
+
+				[[nodiscard]] static auto bind_javascript_code(const string_view_type name, const bool json_arguments = false) -> string_type
+				{
+					string_type code{json_arguments ? "window.external.__bind_json(" : "window.external.__bind("};
+					json::append(code, name);
+					code.append(");");
+					return code;
+				}
+
+				// Called by the implementation for every (string) message posted by javascript.
+				// The message only has to be valid during the call, nothing is copied.
+				auto receive_message(const string_view_type message) -> void
+				{
+					metrics_.messages_received.add();
+					metrics_.bytes_received.add(message.size());
+
+					{
+						const dispatch_scope     scope{*this};
+						const metrics::Stopwatch stopwatch{};
+						dispatch_message(message);
+						metrics_.handler_duration.record(stopwatch.elapsed());
+					}
+					apply_binding_changes();
+				}
+
+				// Called by the implementation for every binary message posted by javascript.
+				auto receive_message(const call_id_type id, const string_view_type name, const bytes_view_type bytes) -> void
+				{
+					metrics_.messages_received.add();
+					metrics_.bytes_received.add(bytes.size());
+
+					{
+						const dispatch_scope     scope{*this};
+						const metrics::Stopwatch stopwatch{};
+						dispatch_message(id, name, bytes);
+						metrics_.handler_duration.record(stopwatch.elapsed());
+					}
+					apply_binding_changes();
+				}
+
+				auto dispatch_message(string_view_type message) -> void
+				{
+					// [*]id:name:argument
+					// A message which is not posted by the stubs is delivered to `GAL_WEBVIEW_METHOD_NAME` as is.
+					const auto is_base64 = message.starts_with('*');
+					if (is_base64) { message.remove_prefix(1); }
+
+					call_id_type     id = invalid_call_id;
+					string_view_type name{GAL_WEBVIEW_METHOD_NAME};
+					string_view_type argument{message};
+					if (const auto id_split = message.find(':'); id_split != string_view_type::npos)
+					{
+						if (const auto name_split = message.find(':', id_split + 1); name_split != string_view_type::npos)
+						{
+							if (const auto [ptr, ec] = std::from_chars(message.data(), message.data() + id_split, id);
+								ec == std::errc{} && ptr == message.data() + id_split)
+							{
+								name     = message.substr(id_split + 1, name_split - id_split - 1);
+								argument = message.substr(name_split + 1);
+							}
+							else { id = invalid_call_id; }
+						}
+					}
+
+					if (is_base64 && id != invalid_call_id)
+					{
+						std::pmr::vector<std::byte> bytes{&message_resource()};
+						bytes.reserve(argument.size() / 4 * 3);
+						if (!base64::decode(bytes, argument))
+						{
+							reject(id, "invalid base64 argument");
+							return;
+						}
+						dispatch_message(id, name, bytes);
+						return;
+					}
+
+					auto* binding = bindings_.find(name);
+					if (!binding)
+					{
+						reject(id, "no such method");
+						return;
+					}
+
+					if (binding->string_handler) { binding->string_handler(rep(), id, argument); }
+					else { binding->binary_handler(rep(), id, std::as_bytes(std::span{argument})); }
+				}
+
+				auto dispatch_message(const call_id_type id, const string_view_type name, const bytes_view_type bytes) -> void
+				{
+					auto* binding = bindings_.find(name);
+					if (!binding)
+					{
+						reject(id, "no such method");
+						return;
+					}
+
+					if (binding->binary_handler) { binding->binary_handler(rep(), id, bytes); }
+					else { binding->string_handler(rep(), id, string_view_type{reinterpret_cast<const char*>(bytes.data()), bytes.size()}); }
+				}
+
+				auto bind_handler(const string_view_type name, binding_type&& binding, const bool json_arguments = false) -> void
+				{
+					if (dispatching_ == 0) { bindings_.insert(name, std::move(binding)); }
+					else { binding_changes_.push_back({.name = make_string(name), .binding = std::move(binding)}); }
+
+					if (name != GAL_WEBVIEW_METHOD_NAME) { set_stub(name, json_arguments); }
+
+					if constexpr (requires { rep().post_bind(name); }) { rep().post_bind(name); }
+				}
+
+				// Nothing changes if the stub is already there (a function bound again), the stubs are written again if its arguments changed.
+				auto set_stub(const string_view_type name, const bool json_arguments) -> void
+				{
+					const auto it = std::ranges::find(stubs_, name, &decltype(stubs_)::value_type::first);
+					if (it != stubs_.end() && it->second == json_arguments) { return; }
+
+					const auto code = bind_javascript_code(name, json_arguments);
+					if (it == stubs_.end())
+					{
+						stubs_.emplace_back(make_string(name), json_arguments);
+						inject_javascript_code_.append(code);
+					}
+					else
+					{
+						it->second = json_arguments;
+						inject_javascript_code_.assign(bridge_javascript_code());
+						for (const auto& [stub_name, stub_json_arguments]: stubs_) { inject_javascript_code_.append(bind_javascript_code(stub_name, stub_json_arguments)); }
+					}
+					if constexpr (requires { rep().post_inject(std::declval<string_type&>()); }) { rep().post_inject(inject_javascript_code_); }
+
+					// the current page
+					if (service_state_ == ServiceStateResult::RUNNING) { eval_async(code); }
+				}
+
+				// `std::string_view` parameters point into the message (or into a buffer if the string has to be decoded).
+				template<typename T>
+				using json_argument_type = std::conditional_t<std::is_same_v<std::remove_cvref_t<T>, string_view_type>, json::InPlaceString, std::remove_cvref_t<T>>;
+
+				template<typename T>
+				[[nodiscard]] static constexpr auto forward_json_argument(json_argument_type<T>& argument) noexcept -> decltype(auto)
+				{
+					if constexpr (std::is_same_v<json_argument_type<T>, json::InPlaceString>) { return string_view_type{argument.value}; }
+					else { return static_cast<json_argument_type<T>&&>(argument); }
+				}
+
+				// Decodes the arguments (a JSON array) into the parameters, invokes the function and settles the call with the result
+				// (through the target: the web view, or the reply of a worker thread).
+				template<typename R, typename... Args, typename Target, typename Invoker>
+				static auto invoke_with_json(Target& target, const call_id_type id, const string_view_type arguments, Invoker invoker) -> void
+				{
+					// the result of a coroutine is the result of its task
+					using result_type = task_value_t<R>;
+
+					static_assert((json::readable<json_argument_type<Args>> && ...), "Unsupported parameter type! (bool, number, string, std::optional / std::vector of them)");
+					static_assert(
+							std::is_void_v<result_type> || json::writable<std::remove_cvref_t<result_type>> || std::is_convertible_v<std::add_lvalue_reference_t<const result_type>, bytes_view_type>,
+							"Unsupported return type! (void, bool, number, string, json::Raw, bytes, std::optional / std::vector of them, or a Task of them)");
+					static_assert(
+							!is_task_v<R> || ((!std::is_reference_v<Args> && !std::is_same_v<std::remove_cv_t<Args>, string_view_type>) && ...),
+							"A coroutine outlives the message, its parameters must own their values (std::string instead of std::string_view, no references)!");
+
+					// On the loop thread the arguments are decoded into the arena (std::pmr strings / vectors included), not for a coroutine which outlives the message.
+					auto values = [&target]() -> std::tuple<json_argument_type<Args>...>
+					{
+						if constexpr (std::is_same_v<Target, impl_type> && !is_task_v<R>)
+						{
+							return std::tuple<json_argument_type<Args>...>{std::allocator_arg, std::pmr::polymorphic_allocator<>{&target.message_resource()}};
+						}
+						else { return {}; }
+					}();
+					if (!std::apply([arguments](auto&... value) -> bool { return json::read_array(arguments, value...); }, values))
+					{
+						target.reject(id, "invalid arguments");
+						return;
+					}
+
+					[&]<std::size_t... I>(std::index_sequence<I...>) -> void
+					{
+						// the arguments are moved into the frame of the coroutine
+						if constexpr (is_task_v<R>) { spawn(settle_task(target, id, invoker(forward_json_argument<Args>(std::get<I>(values))...))); }
+						else if constexpr (std::is_void_v<R>)
+						{
+							invoker(forward_json_argument<Args>(std::get<I>(values))...);
+							target.resolve(id);
+						}
+						else { target.resolve(id, invoker(forward_json_argument<Args>(std::get<I>(values))...)); }
+					}(std::index_sequence_for<Args...>{});
+				}
+
+				template<auto Function, typename Target, typename R, typename... Args>
+				static auto invoke_typed(Target& target, const call_id_type id, const string_view_type arguments, std::type_identity<R(Args...)>) -> void
+				{
+					invoke_with_json<R, Args...>(target, id, arguments, [](auto&&... args) -> decltype(auto) { return std::invoke(Function, std::forward<decltype(args)>(args)...); });
+				}
+
+				// The first parameter is the web view
+				template<auto Function, typename R, typename... Args>
+				static auto invoke_typed(impl_type& web_view, const call_id_type id, const string_view_type arguments, std::type_identity<R(impl_type&, Args...)>) -> void
+				{
+					invoke_with_json<R, Args...>(
+							web_view,
+							id,
+							arguments,
+							[&web_view](auto&&... args) -> decltype(auto) { return std::invoke(Function, web_view, std::forward<decltype(args)>(args)...); });
+				}
+
+				// Settles the call with the result of the task once it completes.
+				template<typename T>
+				static auto settle_task(impl_type& web_view, const call_id_type id, Task<T> task) -> Task<>
+				{
+					if constexpr (std::is_void_v<T>)
+					{
+						co_await std::move(task);
+						web_view.resolve(id);
+					}
+					else { web_view.resolve(id, co_await std::move(task)); }
+				}
+
+				// The handler and the argument live in the frame until the task completes (even if the function is unbound in the meantime).
+				template<typename Handler>
+				static auto run_task_handler(impl_type& web_view, const call_id_type id, const std::shared_ptr<Handler> handler, string_type argument) -> Task<>
+				{
+					co_await settle_task(web_view, id, (*handler)(web_view, std::move(argument)));
+				}
+
+				// `(impl_type&, string_type) -> Task<R>`
+				template<typename Handler>
+				constexpr static auto is_task_handler = []() -> bool
+				{
+					if constexpr (std::is_invocable_v<Handler&, impl_type&, string_type&&>) { return is_task_v<std::invoke_result_t<Handler&, impl_type&, string_type&&>>; }
+					else { return false; }
+				}();
+
+				// Every handler `bind(name, handler)` accepts (see there).
+				template<typename Handler>
+				constexpr static auto is_handler =
+						is_task_handler<Handler> ||
+						std::is_invocable_v<Handler&, impl_type&, call_id_type, string_view_type> ||
+						std::is_invocable_v<Handler&, impl_type&, call_id_type, string_view_type, std::pmr::memory_resource&> ||
+						std::is_invocable_v<Handler&, impl_type&, call_id_type, string_type&&> ||
+						std::is_invocable_v<Handler&, impl_type&, call_id_type, bytes_view_type> ||
+						std::is_invocable_v<Handler&, impl_type&, call_id_type, bytes_view_type, std::pmr::memory_resource&> ||
+						std::is_invocable_v<Handler&, impl_type&, string_view_type> ||
+						std::is_invocable_v<Handler&, impl_type&, string_type&&> ||
+						std::is_invocable_v<Handler&, impl_type&, bytes_view_type>;
+
+				// The writer appends the script to the queue.
+				template<typename Writer>
+				auto enqueue_eval(Writer writer) -> eval_future_type
+				{
+					eval_promise_type promise{};
+					auto              future = promise.get_future();
+
+					if (eval_queue_promises_.empty())
+					{
+						eval_queue_since_ = std::chrono::steady_clock::now();
+						// make sure that the loop does not sleep longer than that
+						if constexpr (requires { rep().do_wake_up_after(eval_batch_.max_delay); })
+						{
+							if (eval_batch_.max_delay.count() != 0) { rep().do_wake_up_after(eval_batch_.max_delay); }
+						}
+					}
+
+					metrics_.evals.add();
+					writer(eval_queue_code_);
+					eval_queue_ends_.push_back(eval_queue_code_.size());
+					eval_queue_promises_.push_back(std::move(promise));
+
+					if (eval_queue_code_.size() >= eval_batch_.max_bytes) { flush_eval(); }
+					return future;
+				}
+
+				auto begin_reply(const call_id_type id, const bool success) -> void
+				{
+					metrics_.replies.add();
+					if (reply_javascript_code_.size() == reply_begin_) { reply_javascript_code_.append(reply_function_name).append("(["); }
+					else { reply_javascript_code_.push_back(','); }
+
+					reply_javascript_code_.push_back('[');
+					json::append(reply_javascript_code_, id);
+					reply_javascript_code_.append(success ? ",1," : ",0,");
+				}
+
+				// `window.external.__bytes("<base64>")`, a `Uint8Array` once evaluated.
+				static auto append_bytes(string_type& out, const bytes_view_type bytes) -> void
+				{
+					out.append("window.external.__bytes(\"");
+					base64::encode(out, bytes);
+					out.append("\")");
+				}
+
+				// The implementation is given the bytes of a binary reply as they are (`do_resolve`), otherwise they are written into the reply script in base64.
+				[[nodiscard]] constexpr static auto transfers_bytes() noexcept -> bool
+				{
+					return requires(impl_type& web_view, const call_id_type id, const bytes_view_type bytes) { web_view.do_resolve(id, bytes); };
+				}
+
+				// For the implementation that cannot transfer bytes directly.
+				auto resolve_as_base64(const call_id_type id, const bytes_view_type bytes) -> void
+				{
+					begin_reply(id, true);
+					append_bytes(reply_javascript_code_, bytes);
+					reply_javascript_code_.push_back(']');
+				}
+
+				auto end_reply_script() -> void
+				{
+					if (reply_javascript_code_.size() == reply_begin_) { return; }
+
+					reply_javascript_code_.append("])");
+					reply_begin_ = reply_javascript_code_.size();
+				}
+
+				// The bytes are sent with the other replies, in the order the calls were settled.
+				auto queue_binary_reply(const call_id_type id, std::vector<std::byte>&& bytes) -> void
+				{
+					metrics_.replies.add();
+					end_reply_script();
+					binary_replies_.push_back({.id = id, .reply_offset = reply_javascript_code_.size(), .bytes = std::move(bytes)});
+				}
+
+				auto flush_reply() -> void
+				{
+					end_reply_script();
+					if (reply_javascript_code_.empty() && binary_replies_.empty()) { return; }
+
+					// The buffer is reused, the implementation copies the script if it needs to keep it.
+					const string_view_type code{reply_javascript_code_};
+					std::size_t            begin = 0;
+					for (const auto& reply: binary_replies_)
+					{
+						if (reply.reply_offset != begin) { eval_async(code.substr(begin, reply.reply_offset - begin)); }
+						begin = reply.reply_offset;
+
+						// the scripts queued before them (the replies included) are executed first
+						flush_eval();
+						metrics_.messages_sent.add();
+						metrics_.bytes_sent.add(reply.bytes.size());
+						if constexpr (transfers_bytes()) { rep().do_resolve(reply.id, bytes_view_type{reply.bytes}); }
+					}
+					if (begin != code.size()) { eval_async(code.substr(begin)); }
+
+					reply_javascript_code_.clear();
+					binary_replies_.clear();
+					reply_begin_ = 0;
+				}
+
+				// Settle the promises of a batch with the result of it (`[ok, value, ok, value...]`).
+				static auto settle_eval_batch(std::vector<eval_promise_type>& promises, eval_result_type&& result) -> void
+				{
+					auto it = promises.begin();
+					if (result.result == EvalResult::SUCCESS)
+					{
+						string_view_type values{result.value};
+						if (values.starts_with('[')) { values.remove_prefix(1); }
+						else { values = {}; }
+
+						for (; it != promises.end(); ++it)
+						{
+							if (values.size() < 2 || (values[0] != '0' && values[0] != '1') || values[1] != ',') { break; }
+							const auto ok = values[0] == '1';
+							values.remove_prefix(2);
+
+							string_type value{};
+							if (!json::read_string(values, value) || values.empty()) { break; }
+							values.remove_prefix(1);
+
+							it->set_value({ok ? EvalResult::SUCCESS : EvalResult::EVAL_FAILED, std::move(value)});
+						}
+
+						result.value = "malformed batch result";
+					}
+
+					for (; it != promises.end(); ++it) { it->set_value({EvalResult::EVAL_FAILED, result.value}); }
+				}
+
+				// The scripts of a batch which did not run (they are not all expressions), every one of them is evaluated on its own.
+				auto eval_alone(const string_view_type code, const std::vector<std::size_t>& ends, std::vector<eval_promise_type>& promises) -> void
+				{
+					std::size_t begin = 0;
+					for (std::size_t i = 0; i < ends.size(); ++i)
+					{
+						const auto script = code.substr(begin, ends[i] - begin);
+						begin             = ends[i];
+
+						metrics_.messages_sent.add();
+						metrics_.bytes_sent.add(script.size());
+						rep().do_eval(script, std::move(promises[i]));
+					}
+				}
+
+				// Records the latency of the scripts of the batch once it is settled (nothing at all without metrics).
+				auto measure_eval(eval_promise_type&& promise, const std::size_t scripts) -> eval_promise_type
+				{
+					if constexpr (!metrics::enabled) { return std::move(promise); }
+					else
+					{
+						eval_promise_type measured{};
+						measured.get_future().then(
+								[this, alive = std::weak_ptr{lifetime_}, promise = std::move(promise), scripts, since = eval_queue_since_](eval_result_type&& result) mutable -> void
+								{
+									if (alive.expired())
+									{
+										promise.set_value(std::move(result));
+										return;
+									}
+
+									const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since);
+									for (std::size_t i = 0; i < scripts; ++i) { metrics_.eval_latency.record(static_cast<std::uint64_t>(latency.count())); }
+									promise.set_value(std::move(result));
+								});
+						return measured;
+					}
+				}
+
+				auto flush_eval() -> void
+				{
+					if (eval_queue_promises_.empty()) { return; }
+
+					if (eval_queue_promises_.size() == 1)
+					{
+						metrics_.messages_sent.add();
+						metrics_.bytes_sent.add(eval_queue_code_.size());
+
+						// nothing to isolate
+						rep().do_eval(eval_queue_code_, measure_eval(std::move(eval_queue_promises_.front()), 1));
+					}
+					else
+					{
+						// Every script is written as it is, as an expression (see `eval_batch_type`),
+						// the line breaks keep a trailing comment of it from commenting the rest out.
+						eval_batch_code_.assign("(()=>{const r=[],s=v=>typeof v==='string'?v:JSON.stringify(v)||'';");
+
+						const string_view_type code{eval_queue_code_};
+						std::size_t            begin = 0;
+						for (const auto end: eval_queue_ends_)
+						{
+							eval_batch_code_.append("try{r.push(1,s((\n");
+							eval_batch_code_.append(code.substr(begin, end - begin));
+							eval_batch_code_.append("\n)))}catch(e){r.push(0,String(e))}");
+							begin = end;
+						}
+						eval_batch_code_.append("return r;})()");
+
+						metrics_.messages_sent.add();
+						metrics_.bytes_sent.add(eval_batch_code_.size());
+
+						const auto        scripts = eval_queue_promises_.size();
+						eval_promise_type batch_promise{};
+						batch_promise.get_future().then(
+								[this,
+								 alive    = std::weak_ptr{lifetime_},
+								 promises = std::exchange(eval_queue_promises_, {}),
+								 code     = make_string(eval_queue_code_),
+								 ends     = eval_queue_ends_](eval_result_type&& result) mutable -> void
+								{
+									// a syntax error, nothing of the batch ran
+									if (result.result == EvalResult::EVAL_FAILED && !alive.expired()) { eval_alone(code, ends, promises); }
+									else { settle_eval_batch(promises, std::move(result)); }
+								});
+						// The buffer is reused, the implementation copies the script if it needs to keep it.
+						rep().do_eval(eval_batch_code_, measure_eval(std::move(batch_promise), scripts));
+					}
+
+					eval_queue_code_.clear();
+					eval_queue_ends_.clear();
+					eval_queue_promises_.clear();
+				}
+
+				// How long the loop may sleep before `process_pending_work()` has something to do, `max()` if it has to wait for something else (a message, a dispatch...).
+				[[nodiscard]] auto pending_work_timeout() const noexcept -> std::chrono::milliseconds
+				{
+					if (!dispatch_queue_.empty() || !worker_replies_.empty() || !reply_javascript_code_.empty() || !binary_replies_.empty()) { return std::chrono::milliseconds::zero(); }
+					if (eval_queue_promises_.empty()) { return std::chrono::milliseconds::max(); }
+
+					const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - eval_queue_since_);
+					return elapsed >= eval_batch_.max_delay ? std::chrono::milliseconds::zero() : eval_batch_.max_delay - elapsed;
+				}
+
+				// The work of the library itself, done once per turn of the loop (before it waits for the next events):
+				// the dispatched functions, the replies of the calls (those of the worker threads included) and the queued scripts.
+				auto process_pending_work() -> void
+				{
+					if (message_arena_.reset == ArenaReset::PER_ITERATION) { release_message_resource(); }
+
+					const metrics::Stopwatch stopwatch{};
+
+					std::uint64_t dispatched = 0;
+					dispatch_queue_.drain(
+							[this, &dispatched](dispatch_callback_type&& function) -> void
+							{
+								++dispatched;
+								function(rep());
+							});
+					if (dispatched != 0) { metrics_.dispatch_queue_depth.record(dispatched); }
+
+					worker_replies_.drain(
+							[this](worker_reply_type&& reply) -> void
+							{
+								if (reply.binary)
+								{
+									queue_binary_reply(reply.id, std::move(*reply.binary));
+									return;
+								}
+
+								begin_reply(reply.id, reply.success);
+								reply_javascript_code_.append(reply.value).push_back(']');
+							});
+					flush_reply();
+					if (eval_batch_.max_delay.count() == 0 || std::chrono::steady_clock::now() - eval_queue_since_ >= eval_batch_.max_delay) { flush_eval(); }
+
+					metrics_.iteration_duration.record(stopwatch.elapsed());
+				}
+
+				// Called by the implementation for every phase of a navigation of the top frame, `url` is the url of the document at that time.
+				auto navigation_changed(const NavigationEvent event, const string_view_type url, const string_view_type error = {}) -> void
+				{
+					const auto now = navigation_clock_type::now();
+					switch (event)
+					{
+						case NavigationEvent::STARTED:
+						{
+							// in place, the strings keep their buffers (and their allocator)
+							navigation_.id += 1;
+							navigation_.url        = url;
+							navigation_.started    = now;
+							navigation_.redirected = {};
+							navigation_.committed  = {};
+							navigation_.finished   = {};
+							navigation_.error.clear();
+							navigation_.timing.reset();
+							break;
+						}
+						case NavigationEvent::REDIRECTED:
+						{
+							navigation_.url        = url;
+							navigation_.redirected = now;
+							break;
+						}
+						case NavigationEvent::COMMITTED:
+						{
+							navigation_.url       = url;
+							navigation_.committed = now;
+							record_navigation(metrics_.navigation_commit, now);
+							break;
+						}
+						case NavigationEvent::FINISHED:
+						{
+							// an engine may report a failed navigation as finished too
+							if (navigation_.failed()) { return; }
+							navigation_.finished = now;
+							record_navigation(metrics_.navigation_duration, now);
+							break;
+						}
+						case NavigationEvent::FAILED:
+						{
+							navigation_.finished = now;
+							navigation_.error    = error.empty() ? string_view_type{"unknown error"} : error;
+							metrics_.navigation_failures.add();
+							break;
+						}
+						case NavigationEvent::TIMING: { break; }
+					}
+
+					if (navigation_callback_) { navigation_callback_(rep(), event, navigation_); }
+
+					if (event == NavigationEvent::FINISHED || event == NavigationEvent::FAILED) { settle_navigation_promises(); }
+
+					if (event == NavigationEvent::FINISHED && navigation_callback_) { fetch_navigation_timing(); }
+				}
+
+			private:
+				// `add_script` / `add_style_sheet`
+				auto add_injection(const bool style_sheet, const string_view_type code, const InjectFrames frames, const InjectTime time) -> injection_id_type
+				{
+					const auto& injection = injections_.emplace_back(injection_type{
+							.id          = ++last_injection_id_,
+							.style_sheet = style_sheet,
+							.frames      = frames,
+							.time        = time,
+							.code        = make_string(code)});
+
+					// otherwise the implementation injects everything when the service starts
+					if (service_state_ == ServiceStateResult::RUNNING)
+					{
+						if constexpr (requires { rep().do_add_injection(injection); }) { rep().do_add_injection(injection); }
+					}
+
+					return injection.id;
+				}
+
+				// The time since the start of the current navigation (unless its start has not been reported).
+				auto record_navigation(metrics::Histogram& histogram, const navigation_clock_type::time_point now) -> void
+				{
+					if (navigation_.started == navigation_clock_type::time_point{}) { return; }
+					histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - navigation_.started).count()));
+				}
+
+				auto settle_navigation_promises() -> void
+				{
+					if (navigation_promises_.empty()) { return; }
+
+					// a continuation may navigate again (and add a promise)
+					const auto it = std::ranges::stable_partition(
+											navigation_promises_,
+											[id = navigation_.id](const auto& pair) -> bool { return pair.first > id; })
+											.begin();
+					std::vector<std::pair<std::uint32_t, navigation_promise_type>> settled{std::make_move_iterator(it), std::make_move_iterator(navigation_promises_.end())};
+					navigation_promises_.erase(it, navigation_promises_.end());
+
+					for (auto& [id, promise]: settled) { promise.set_value(navigation_type{navigation_}); }
+				}
+
+				// One script once the navigation finished, the result is reported as TIMING (unless another navigation started in the meantime).
+				auto fetch_navigation_timing() -> void
+				{
+					constexpr string_view_type code{
+							"(()=>{const t=performance.getEntriesByType('navigation')[0];"
+							"return t?[t.redirectStart,t.redirectEnd,t.fetchStart,t.domainLookupStart,t.domainLookupEnd,t.connectStart,t.connectEnd,"
+							"t.requestStart,t.responseStart,t.responseEnd,t.domInteractive,t.domContentLoadedEventEnd,t.domComplete,t.loadEventEnd,"
+							"t.transferSize||0,t.decodedBodySize||0]:null})()"};
+
+					eval_async(code).then(
+							[this, alive = std::weak_ptr{lifetime_}, id = navigation_.id](eval_result_type&& result) -> void
+							{
+								if (alive.expired() || result.result != EvalResult::SUCCESS || navigation_.id != id || !navigation_callback_) { return; }
+
+								navigation_timing_type timing{};
+								if (!json::read_array(
+											result.value,
+											timing.redirect_start,
+											timing.redirect_end,
+											timing.fetch_start,
+											timing.domain_lookup_start,
+											timing.domain_lookup_end,
+											timing.connect_start,
+											timing.connect_end,
+											timing.request_start,
+											timing.response_start,
+											timing.response_end,
+											timing.dom_interactive,
+											timing.dom_content_loaded_event_end,
+											timing.dom_complete,
+											timing.load_event_end,
+											timing.transfer_size,
+											timing.decoded_body_size)) { return; }
+
+								navigation_.timing = timing;
+								navigation_callback_(rep(), NavigationEvent::TIMING, navigation_);
+							});
+				}
 
 			public:
 				~WebViewBase() noexcept = default;
@@ -109,10 +1318,279 @@ namespace gal::web_view
 				auto operator=(const WebViewBase&) -> WebViewBase& = delete;
 				auto operator=(WebViewBase&&) -> WebViewBase&      = delete;
 
-				auto register_javascript_callback(javascript_callback_type&& callback) -> void
+				// Bind `window.external.<name>(arg)`, the handler is one of:
+				//	(impl_type&, call_id_type, string_view_type) -> the handler is responsible for settling the call (at any time later)
+				//	(impl_type&, call_id_type, string_view_type, std::pmr::memory_resource&) -> same as above, with the arena of the message (see `message_resource`)
+				//	(impl_type&, call_id_type, string_type&&) -> same as above, but the handler owns a copy of the string
+				//	(impl_type&, call_id_type, bytes_view_type) -> same as above, but the argument is viewed as bytes
+				//	(impl_type&, call_id_type, bytes_view_type, std::pmr::memory_resource&) -> same as above, with the arena of the message
+				//	(impl_type&, string_view_type) -> the call is resolved (with `undefined`) as soon as the handler returns
+				//	(impl_type&, string_type&&) -> same as above, but the handler owns a copy of the string
+				//	(impl_type&, bytes_view_type) -> same as above, but the argument is viewed as bytes
+				//	(impl_type&, string_type) -> Task<R> the call is settled with the result of the task once it completes (R: void or anything `resolve` accepts)
+				// A string_view_type / bytes_view_type is only valid during the call, prefer it unless the argument has to be kept.
+				template<typename Handler>
+					requires is_handler<std::decay_t<Handler>>
+				auto bind(const string_view_type name, Handler&& handler) -> void
 				{
-					current_callback_.swap(callback);
-					if constexpr (requires { rep().post_register_javascript_callback(std::declval<javascript_callback_type&>()); }) { rep().post_register_javascript_callback(current_callback_); }
+					using handler_type = std::decay_t<Handler>;
+
+					if constexpr (is_task_handler<handler_type>)
+					{
+						bind_handler(
+								name,
+								{.string_handler = [h = std::make_shared<handler_type>(std::forward<Handler>(handler))](impl_type& web_view, const call_id_type id, const string_view_type string) -> void
+								 { spawn(run_task_handler(web_view, id, h, web_view.make_string(string))); },
+								 .binary_handler = {}});
+					}
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, call_id_type, string_view_type>) { bind_handler(name, {.string_handler = rpc_callback_type{std::forward<Handler>(handler)}, .binary_handler = {}}); }
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, call_id_type, string_view_type, std::pmr::memory_resource&>)
+					{
+						bind_handler(
+								name,
+								{.string_handler = [h = std::forward<Handler>(handler)](impl_type& web_view, const call_id_type id, const string_view_type string) mutable -> void { h(web_view, id, string, web_view.message_resource()); },
+								 .binary_handler = {}});
+					}
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, call_id_type, string_type&&>)
+					{
+						bind_handler(
+								name,
+								{.string_handler = [h = std::forward<Handler>(handler)](impl_type& web_view, const call_id_type id, const string_view_type string) mutable -> void { h(web_view, id, web_view.make_string(string)); },
+								 .binary_handler = {}});
+					}
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, call_id_type, bytes_view_type>) { bind_handler(name, {.string_handler = {}, .binary_handler = binary_callback_type{std::forward<Handler>(handler)}}); }
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, call_id_type, bytes_view_type, std::pmr::memory_resource&>)
+					{
+						bind_handler(
+								name,
+								{.string_handler = {},
+								 .binary_handler = [h = std::forward<Handler>(handler)](impl_type& web_view, const call_id_type id, const bytes_view_type bytes) mutable -> void { h(web_view, id, bytes, web_view.message_resource()); }});
+					}
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, string_view_type>)
+					{
+						bind_handler(
+								name,
+								{.string_handler = [h = std::forward<Handler>(handler)](impl_type& web_view, const call_id_type id, const string_view_type string) mutable -> void
+								 {
+									 h(web_view, string);
+									 web_view.resolve(id);
+								 },
+								 .binary_handler = {}});
+					}
+					else if constexpr (std::is_invocable_v<handler_type&, impl_type&, string_type&&>)
+					{
+						bind_handler(
+								name,
+								{.string_handler = [h = std::forward<Handler>(handler)](impl_type& web_view, const call_id_type id, const string_view_type string) mutable -> void
+								 {
+									 h(web_view, web_view.make_string(string));
+									 web_view.resolve(id);
+								 },
+								 .binary_handler = {}});
+					}
+					else
+					{
+						static_assert(std::is_invocable_v<handler_type&, impl_type&, bytes_view_type>, "Unsupported handler!");
+
+						bind_handler(
+								name,
+								{.string_handler = {},
+								 .binary_handler = [h = std::forward<Handler>(handler)](impl_type& web_view, const call_id_type id, const bytes_view_type bytes) mutable -> void
+								 {
+									 h(web_view, bytes);
+									 web_view.resolve(id);
+								 }});
+					}
+				}
+
+				// Bind `window.external.<name>(...args)` to a function (a function pointer or a captureless lambda), the arguments and the result are marshalled as JSON:
+				//	auto add(int a, int b) -> int;
+				//	web_view.bind<&add>("add"); => `await window.external.add(1, 2) === 3`
+				// The first parameter can be `impl_type&`, the others can be bool, a number, a string (std::string / std::pmr::string / std::string_view) or std::optional / std::vector of them,
+				// the result can be any of them, void, `json::Raw` or bytes. Any other type does not compile, a call whose arguments do not match the parameters is rejected.
+				template<auto Function>
+				auto bind(const string_view_type name) -> void
+				{
+					using signature_type = typename FunctionTraits<std::remove_cvref_t<decltype(Function)>>::signature_type;
+
+					bind_handler(
+							name,
+							{.string_handler = [](impl_type& web_view, const call_id_type id, const string_view_type arguments) -> void
+							 { invoke_typed<Function>(web_view, id, arguments, std::type_identity<signature_type>{}); },
+							 .binary_handler = {}},
+							true);
+				}
+
+				// Bind `window.external.<name>(arg)` to a function which does not need the web view, so that it can run on the worker threads:
+				//	(string_view_type) -> R / (string_type&&) -> R / (bytes_view_type) -> R, the call is settled with the result (R: void or anything `resolve` accepts)
+				// Execution::INLINE runs it while the message is dispatched, POOL / STRAND on the worker threads (the argument is copied for them),
+				// the loop thread only sends the replies back (all the replies which arrived since the last iteration in one script).
+				// An exception escaping the function rejects the call, so does a call arriving when `worker_pool().capacity` calls are waiting.
+				template<typename Handler>
+				auto bind(const string_view_type name, Handler&& handler, const Execution execution) -> void
+				{
+					using handler_type = std::decay_t<Handler>;
+
+					// shared with the workers, the calls already queued still run if the function is unbound
+					auto h      = std::make_shared<handler_type>(std::forward<Handler>(handler));
+					auto strand = prepare_execution(execution);
+
+					if constexpr (std::is_invocable_v<handler_type&, string_view_type> || std::is_invocable_v<handler_type&, string_type&&>)
+					{
+						constexpr auto by_view = std::is_invocable_v<handler_type&, string_view_type>;
+
+						bind_handler(
+								name,
+								{.string_handler = [h, strand, execution](impl_type& web_view, const call_id_type id, const string_view_type string) -> void
+								 {
+									 if (execution == Execution::INLINE)
+									 {
+										 if constexpr (by_view) { invoke_and_settle(web_view, id, *h, string); }
+										 else { invoke_and_settle(web_view, id, *h, web_view.make_string(string)); }
+										 return;
+									 }
+
+									 web_view.execute_on_workers(
+											 strand.get(),
+											 id,
+											 // not with the allocator of the web view, the copy is released by the worker
+											 [h, id, argument = string_type{string}](worker_reply_type& reply) mutable -> void
+											 {
+												 if constexpr (by_view) { invoke_and_settle(reply, id, *h, string_view_type{argument}); }
+												 else { invoke_and_settle(reply, id, *h, std::move(argument)); }
+											 });
+								 },
+								 .binary_handler = {}});
+					}
+					else
+					{
+						static_assert(std::is_invocable_v<handler_type&, bytes_view_type>, "Unsupported handler! (string_view_type / string_type&& / bytes_view_type, without the web view)");
+
+						bind_handler(
+								name,
+								{.string_handler = {},
+								 .binary_handler = [h, strand, execution](impl_type& web_view, const call_id_type id, const bytes_view_type bytes) -> void
+								 {
+									 if (execution == Execution::INLINE)
+									 {
+										 invoke_and_settle(web_view, id, *h, bytes);
+										 return;
+									 }
+
+									 web_view.execute_on_workers(
+											 strand.get(),
+											 id,
+											 [h, id, argument = std::vector<std::byte>{bytes.begin(), bytes.end()}](worker_reply_type& reply) -> void
+											 { invoke_and_settle(reply, id, *h, bytes_view_type{argument}); });
+								 }});
+					}
+				}
+
+				// `bind<&function>(name)` (the arguments and the result are marshalled as JSON) with an execution, the function cannot take the web view.
+				// The arguments are decoded by the worker thread too.
+				template<auto Function>
+				auto bind(const string_view_type name, const Execution execution) -> void
+				{
+					using traits_type    = FunctionTraits<std::remove_cvref_t<decltype(Function)>>;
+					using signature_type = typename traits_type::signature_type;
+
+					static_assert(!is_task_v<typename traits_type::return_type>, "A coroutine cannot run on the worker threads, bind it without an execution!");
+					if constexpr (traits_type::arity != 0)
+					{
+						static_assert(
+								!std::is_same_v<std::tuple_element_t<0, typename traits_type::parameter_type>, impl_type&>,
+								"A function running on the worker threads cannot use the web view, bind it without an execution!");
+					}
+
+					bind_handler(
+							name,
+							{.string_handler = [strand = prepare_execution(execution), execution](impl_type& web_view, const call_id_type id, const string_view_type arguments) -> void
+							 {
+								 if (execution == Execution::INLINE)
+								 {
+									 settle_or_reject(web_view, id, [&]() -> void { invoke_typed<Function>(web_view, id, arguments, std::type_identity<signature_type>{}); });
+									 return;
+								 }
+
+								 web_view.execute_on_workers(
+										 strand.get(),
+										 id,
+										 [id, copy = string_type{arguments}](worker_reply_type& reply) -> void
+										 { settle_or_reject(reply, id, [&]() -> void { invoke_typed<Function>(reply, id, copy, std::type_identity<signature_type>{}); }); });
+							 },
+							 .binary_handler = {}},
+							true);
+				}
+
+				// The stub is left in place, calling it will be rejected (binding the function again reuses it).
+				// A handler may bind / unbind (itself included), the table is changed once the message has been dispatched.
+				auto unbind(const string_view_type name) -> bool
+				{
+					if (dispatching_ == 0) { return bindings_.erase(name); }
+
+					const auto bound = is_bound(name);
+					binding_changes_.push_back({.name = make_string(name), .binding = std::nullopt});
+					return bound;
+				}
+
+				// `bind(GAL_WEBVIEW_METHOD_NAME, callback)`, the callback is any handler `bind` accepts
+				// (the former `(impl_type&, string_type&&) -> void` callback is one of them, its call is resolved with `undefined` once it returns).
+				template<typename Callback>
+					requires is_handler<std::decay_t<Callback>>
+				auto register_javascript_callback(Callback&& callback) -> void { bind(GAL_WEBVIEW_METHOD_NAME, std::forward<Callback>(callback)); }
+
+				// Fulfill the Promise returned by `window.external.<name>` with `undefined`.
+				auto resolve(const call_id_type id) -> void
+				{
+					if (id == invalid_call_id) { return; }
+
+					begin_reply(id, true);
+					reply_javascript_code_.append("undefined]");
+				}
+
+				// Fulfill the Promise returned by `window.external.<name>`.
+				// The value can be a string, a number, a boolean, nullptr or an already serialized `json::Raw`.
+				template<typename T>
+					requires(!std::is_convertible_v<const T&, bytes_view_type>)
+				auto resolve(const call_id_type id, const T& value) -> void
+				{
+					if (id == invalid_call_id) { return; }
+
+					begin_reply(id, true);
+					json::append(reply_javascript_code_, value);
+					reply_javascript_code_.push_back(']');
+				}
+
+				// Fulfill the Promise returned by `window.external.<name>` with a `Uint8Array`.
+				// The bytes are copied, they do not have to outlive the call.
+				// Like the other replies they are sent during the next iteration, the calls are settled in the order they were resolved / rejected.
+				auto resolve(const call_id_type id, const bytes_view_type bytes) -> void
+				{
+					if (id == invalid_call_id) { return; }
+
+					if constexpr (transfers_bytes()) { queue_binary_reply(id, {bytes.begin(), bytes.end()}); }
+					else { resolve_as_base64(id, bytes); }
+				}
+
+				// Reject the Promise returned by `window.external.<name>`.
+				auto reject(const call_id_type id, const string_view_type reason) -> void
+				{
+					if (id == invalid_call_id) { return; }
+
+					begin_reply(id, false);
+					json::append(reply_javascript_code_, reason);
+					reply_javascript_code_.push_back(']');
+				}
+
+				// Serve `<scheme>://<path>` from the registry (e.g. `register_scheme("app", assets)` + `navigate("app:///index.html")`).
+				// The registry is not copied, it must outlive the web view.
+				// The requests are served by the web view which made them, another web view may register the same scheme with another registry.
+				auto register_scheme(const string_view_type scheme, const AssetRegistry& registry) -> void
+				{
+					static_assert(requires { rep().do_register_scheme(scheme); }, "The implementation does not support custom schemes!");
+
+					schemes_.emplace_back(make_string(scheme), &registry);
+					if (service_state_ == ServiceStateResult::RUNNING) { rep().do_register_scheme(scheme); }
 				}
 
 				auto set_window_title(string_type&& title) -> void
@@ -131,7 +1609,7 @@ namespace gal::web_view
 					else
 					{
 						if constexpr (requires { rep().do_set_window_title(std::declval<string_view_type>()); }) { rep().do_set_window_title(title); }
-						else { rep().do_set_window_title(string_type{title}); }
+						else { rep().do_set_window_title(make_string(title)); }
 					}
 				}
 
@@ -167,22 +1645,175 @@ namespace gal::web_view
 					}
 
 					if constexpr (requires { rep().do_navigate(std::declval<string_view_type>()); }) { return rep().do_navigate(target_url); }
-					else { return rep().do_navigate(string_type{target_url}); }
+					else { return rep().do_navigate(make_string(target_url)); }
 				}
 
-				auto inject(const string_view_type inject_javascript_code) -> void
+				// `co_await web_view.navigate_async(url)`, settled with the navigation once it finished (or failed), see `current_navigation()`.
+				// A navigation that never starts (the same document...) never settles it.
+				auto navigate_async(const string_view_type target_url) -> navigation_future_type
+				{
+					navigation_promise_type promise{};
+					auto                    future = promise.get_future();
+
+					if (navigate(target_url) == NavigateResult::NAVIGATE_FAILED)
+					{
+						navigation_type navigation{};
+						navigation.url   = target_url;
+						navigation.error = "navigate failed";
+						promise.set_value(std::move(navigation));
+					}
+					// a navigation already in progress does not settle it
+					else { navigation_promises_.emplace_back(navigation_.id + 1, std::move(promise)); }
+
+					return future;
+				}
+
+				// The callback is invoked for every phase of every navigation from now on (see `NavigationEvent`).
+				// Once a navigation finished, its Navigation Timing is fetched (one script) and reported as TIMING.
+				auto on_navigation(navigation_callback_type&& callback) -> void { navigation_callback_ = std::move(callback); }
+
+				// The current (or the last) navigation, `id` is 0 before the first one.
+				[[nodiscard]] constexpr auto current_navigation() const noexcept -> const navigation_type& { return navigation_; }
+
+				// The script is wrapped into an IIFE and injected at the start of every document (of the top frame), see `add_script`.
+				auto inject(const string_view_type inject_javascript_code) -> injection_id_type
 				{
-					// todo: IIFE?
 					constexpr string_view_type iife_left{"(() => {"};
 					constexpr string_view_type iife_right{"})()"};
 
-					inject_javascript_code_.append(iife_left).append(inject_javascript_code).append(iife_right);
+					string_type code{};
+					code.reserve(iife_left.size() + inject_javascript_code.size() + iife_right.size());
+					code.append(iife_left).append(inject_javascript_code).append(iife_right);
 
-					if constexpr (requires { rep().post_inject(std::declval<string_type&>()); }) { rep().post_inject(inject_javascript_code_); }
+					return add_script(code);
 				}
 
-				auto eval(string_view_type javascript_code) noexcept(noexcept(std::declval<impl_type&>().do_eval(javascript_code)))
-					-> void { return rep().do_eval(javascript_code); }
+				// Injected into every document loaded from now on (after the bridge), the current document is left alone (`eval_async` the script too if needed).
+				// Returns the id of the script (see `remove_injection`).
+				auto add_script(
+						const string_view_type javascript_code,
+						const InjectFrames     frames = InjectFrames::TOP_FRAME,
+						const InjectTime       time   = InjectTime::DOCUMENT_START) -> injection_id_type
+				{
+					return add_injection(false, javascript_code, frames, time);
+				}
+
+				// Applied to every document loaded from now on, see `add_script`.
+				auto add_style_sheet(const string_view_type css, const InjectFrames frames = InjectFrames::TOP_FRAME) -> injection_id_type
+				{
+					return add_injection(true, css, frames, InjectTime::DOCUMENT_START);
+				}
+
+				// The documents loaded from now on do not get the script / style sheet, returns false if there is no such injection.
+				auto remove_injection(const injection_id_type id) -> bool
+				{
+					const auto it = std::ranges::find(injections_, id, &injection_type::id);
+					if (it == injections_.end()) { return false; }
+
+					if (service_state_ == ServiceStateResult::RUNNING)
+					{
+						if constexpr (requires { rep().do_remove_injection(*it); }) { rep().do_remove_injection(*it); }
+					}
+
+					injections_.erase(it);
+					return true;
+				}
+
+				// In the order they are injected.
+				[[nodiscard]] constexpr auto injections() const noexcept -> std::span<const injection_type> { return injections_; }
+
+				// Returns immediately, the result is delivered on the loop thread once the script has been executed.
+				// The script is queued until the next `iteration()` (see `eval_batch_type`), an error only fails the script itself.
+				// Scripts evaluated before the page has been loaded are deferred until the load finishes.
+				auto eval_async(const string_view_type javascript_code) -> eval_future_type
+				{
+					return enqueue_eval([javascript_code](string_type& code) -> void { code.append(javascript_code); });
+				}
+
+				// `eval_async("<function>(<args>...)")`, the arguments are serialized (as JSON literals) straight into the queue, no script is built for them.
+				// The strings are escaped, whatever they contain they cannot inject anything. The function is not, it is a (trusted) javascript expression.
+				template<typename... Args>
+				auto eval_call(const string_view_type function, const Args&... args) -> eval_future_type
+				{
+					static_assert((json::writable<Args> && ...), "Unsupported argument type! (bool, number, string, json::Raw, std::optional / std::vector of them)");
+
+					return enqueue_eval(
+							[function, &args...](string_type& code) -> void
+							{
+								code.append(function).push_back('(');
+								if constexpr (sizeof...(Args) != 0)
+								{
+									// `,arg` for every argument, then drop the first comma
+									const auto first = code.size();
+									((code.push_back(','), json::append(code, args)), ...);
+									code.erase(first, 1);
+								}
+								code.push_back(')');
+							});
+				}
+
+				// Thread safe, the function is invoked on the loop thread during the next `iteration()`.
+				// Every other member function must only be called on the loop thread, use this to call them from other threads.
+				template<typename Function>
+				auto dispatch(Function&& function) -> void
+				{
+					// only the first one wakes up the loop, the others will be drained with it
+					if (dispatch_queue_.push(dispatch_callback_type{std::forward<Function>(function)})) { rep().do_wake_up(); }
+				}
+
+				// Thread safe, the script is copied and evaluated on the loop thread (see `eval_async`).
+				auto dispatch_eval(const string_view_type javascript_code) -> void
+				{
+					// not with the allocator of the web view, which may not be thread safe
+					dispatch([code = string_type{javascript_code}](impl_type& web_view) -> void { web_view.eval_async(code); });
+				}
+
+				auto set_eval_batch(const eval_batch_type batch) noexcept -> void { eval_batch_ = batch; }
+
+				[[nodiscard]] constexpr auto eval_batch() const noexcept -> eval_batch_type { return eval_batch_; }
+
+				// Before the first function bound with `Execution::POOL` / `Execution::STRAND`, the worker threads are created with it.
+				auto set_worker_pool(const worker_pool_type pool) noexcept -> void
+				{
+					assert(!worker_threads_ && "The worker threads are running already!");
+					worker_pool_ = pool;
+				}
+
+				[[nodiscard]] constexpr auto worker_pool() const noexcept -> worker_pool_type { return worker_pool_; }
+
+				[[nodiscard]] auto get_allocator() const noexcept -> allocator_type { return allocator_; }
+
+				// Thread safe: `metrics().snapshot()`, `metrics::append_prometheus` / `metrics::write_prometheus` export a snapshot.
+				[[nodiscard]] auto metrics() const noexcept -> const metrics_type& { return metrics_; }
+
+				// Not while a message is being dispatched, the arena is reallocated.
+				auto set_message_arena(const message_arena_type arena) -> void
+				{
+					assert(dispatching_ == 0 && "A message is being dispatched!");
+					message_arena_ = arena;
+					reset_message_arena();
+				}
+
+				[[nodiscard]] constexpr auto message_arena() const noexcept -> message_arena_type { return message_arena_; }
+
+				// A monotonic arena for the temporaries of the message handlers (loop thread only): allocating is a pointer bump, deallocating does nothing,
+				// everything is released at once after the message has been dispatched (or once per `iteration()`, see `message_arena_type`).
+				// The arguments of the functions bound with `bind<&function>` are decoded into it (std::pmr::string / std::pmr::vector parameters included),
+				// nothing allocated from it may be kept beyond the dispatch (or the iteration).
+				[[nodiscard]] auto message_resource() noexcept -> std::pmr::memory_resource& { return *message_resource_; }
+
+				// Blocks (by running the loop) until the script has been executed.
+				// Nothing is evaluated if the service is not running (unlike `eval_async`, which queues the script until it starts).
+				auto eval(const string_view_type javascript_code) -> eval_result_type
+				{
+					if (service_state_ != ServiceStateResult::RUNNING) { return {EvalResult::SERVICE_NOT_READY_YET, {}}; }
+
+					auto future = eval_async(javascript_code);
+					while (!future.ready() && iteration()) {}
+
+					if (!future.ready()) { return {EvalResult::EVAL_FAILED, {}}; }
+					return std::move(future).get();
+				}
 
 				auto service_start() noexcept(noexcept(std::declval<impl_type&>().do_service_start())) -> ServiceStartResult
 				{
@@ -191,8 +1822,29 @@ namespace gal::web_view
 					return rep().do_service_start();
 				}
 
-				auto iteration() noexcept(noexcept(std::declval<impl_type&>().do_iteration()))
-					-> bool { return rep().do_iteration(); }
+				// Blocks until (at least) one event has been handled.
+				auto iteration() -> bool
+				{
+					process_pending_work();
+					return rep().do_iteration();
+				}
+
+				// Waits at most `timeout` for an event, then handles every event which is ready (not only one of them).
+				auto iteration(const std::chrono::milliseconds timeout) -> bool
+				{
+					process_pending_work();
+					return rep().do_iteration(timeout);
+				}
+
+				// Handles every event which is ready, never blocks.
+				auto poll() -> bool { return iteration(std::chrono::milliseconds::zero()); }
+
+				// Runs the loop until `shutdown()`, the native loop is used directly if the implementation has one.
+				auto run() -> void
+				{
+					if constexpr (requires { rep().do_run(); }) { rep().do_run(); }
+					else { while (iteration()) {} }
+				}
 
 				auto shutdown() noexcept(noexcept(std::declval<impl_type&>().do_shutdown()))
 					-> void { return rep().do_shutdown(); }
@@ -0,0 +1,142 @@
+#pragma once
+
+#if defined(GAL_WEBVIEW_PLATFORM_LINUX)
+
+#include <webview/impl/v3/web_view_base.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// #include <webkitgtk-4.0/webkit2/webkit2.h>
+struct _WebKitWebContext;
+struct _WebKitUserScript;
+struct _WebKitUserStyleSheet;
+struct _GtkWidget;
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		class WebViewLinux;
+
+		// Owns what the web views of a process can share: the WebKitWebContext (network process, web process pool, caches, website data) and the loop.
+		// Every web view constructed with the host uses its context, and the loop of the host (`run()`) keeps running until the last of them is shut down.
+		// The host must outlive its web views.
+		class WebViewHost
+		{
+			friend WebViewLinux;
+
+		public:
+			using string_type      = std::string;
+			using string_view_type = std::string_view;
+
+			enum class ProcessModel : std::uint8_t
+			{
+				// All the web views share one web process (a crash takes all of them down).
+				SHARED,
+				// Every web view has its own web process.
+				PER_VIEW,
+			};
+
+			enum class CacheModel : std::uint8_t
+			{
+				// No memory cache at all, the smallest footprint (local content).
+				DOCUMENT_VIEWER,
+				// A small memory cache.
+				DOCUMENT_BROWSER,
+				// The biggest memory cache.
+				WEB_BROWSER,
+			};
+
+			struct options_type
+			{
+				ProcessModel process_model = ProcessModel::SHARED;
+				CacheModel   cache_model   = CacheModel::DOCUMENT_VIEWER;
+				// Where the website data (cookies, local storage...) and the caches are stored, nothing is stored on disk if both are empty.
+				string_type data_directory  = {};
+				string_type cache_directory = {};
+			};
+
+		private:
+			options_type       options_;
+			_WebKitWebContext* web_context_;
+
+			// Every web view constructed with the host, in order.
+			std::vector<WebViewLinux*> views_;
+			std::size_t                running_views_;
+			// Set while `run()` runs gtk_main, `quit()` leaves nothing else (a loop run by someone else is left alone).
+			bool runs_loop_;
+
+			// One of them is set
+			struct user_content_type
+			{
+				_WebKitUserScript*     script;
+				_WebKitUserStyleSheet* style_sheet;
+				// the web views using it
+				std::size_t users;
+			};
+
+			// The same script (the bridge of web views binding the same functions, a script added to every web view...) is only created (and parsed) once.
+			// The key is the kind / frames / time of the content (one character) followed by the content itself.
+			std::unordered_map<string_type, user_content_type> user_contents_;
+
+			// A new reference (web views without a host own theirs)
+			[[nodiscard]] static auto make_user_script(string_view_type javascript_code, InjectFrames frames, InjectTime time) -> _WebKitUserScript*;
+
+			[[nodiscard]] static auto make_user_style_sheet(string_view_type css, InjectFrames frames) -> _WebKitUserStyleSheet*;
+
+			// WebKitUserScript* / WebKitUserStyleSheet*, owned by the host until the last web view releases it.
+			[[nodiscard]] auto acquire_user_script(string_view_type javascript_code, InjectFrames frames, InjectTime time) -> _WebKitUserScript*;
+
+			[[nodiscard]] auto acquire_user_style_sheet(string_view_type css, InjectFrames frames) -> _WebKitUserStyleSheet*;
+
+			auto release(const _WebKitUserScript* script) -> void;
+
+			auto release(const _WebKitUserStyleSheet* style_sheet) -> void;
+
+			auto attach(WebViewLinux& web_view) -> void;
+
+			auto detach(WebViewLinux& web_view) -> void;
+
+			// The web view whose web process a new one shares (SHARED), nullptr if there is none (yet).
+			[[nodiscard]] auto related_view(const WebViewLinux& web_view) const noexcept -> _GtkWidget*;
+
+			auto on_service_start() -> void;
+
+			auto on_shutdown() -> void;
+
+		public:
+			WebViewHost();
+
+			explicit WebViewHost(options_type options);
+
+			WebViewHost(const WebViewHost&)                    = delete;
+			WebViewHost(WebViewHost&&)                         = delete;
+			auto operator=(const WebViewHost&) -> WebViewHost& = delete;
+			auto operator=(WebViewHost&&) -> WebViewHost&      = delete;
+
+			~WebViewHost() noexcept;
+
+			// false if GTK could not be initialized (no display...)
+			[[nodiscard]] constexpr auto initialized() const noexcept -> bool { return web_context_ != nullptr; }
+
+			[[nodiscard]] constexpr auto options() const noexcept -> const options_type& { return options_; }
+
+			// WebKitWebContext*
+			[[nodiscard]] constexpr auto web_context() const noexcept -> _WebKitWebContext* { return web_context_; }
+
+			// The web views which have been started and not shut down yet.
+			[[nodiscard]] constexpr auto running_views() const noexcept -> std::size_t { return running_views_; }
+
+			// Runs the loop (of every web view) until the last running web view is shut down or `quit()` is called.
+			auto run() -> void;
+
+			// Leaves `run()`, nothing happens if it is not running.
+			auto quit() -> void;
+		};
+	}
+}
+
+#endif
@@ -3,29 +3,109 @@
 #if defined(GAL_WEBVIEW_PLATFORM_LINUX)
 
 #include <webview/impl/v3/web_view_base.hpp>
+#include <webview/impl/v3/web_view_host_linux_v3.hpp>
+#include <span>
+#include <vector>
 
 // #include <gtk-3.0/gtk/gtkwidget.h>
 // gtktypes.h
 struct _GtkWidget;
+// gmain.h
+struct _GSource;
+// webkit2.h
+struct _WebKitUserContentManager;
+struct _WebKitUserScript;
+struct _WebKitUserStyleSheet;
 
 namespace gal::web_view::impl
 {
 	inline namespace v3
 	{
+		class WebViewPool;
+
 		class WebViewLinux final : public WebViewBase<WebViewLinux>
 		{
 			friend WebViewBase;
+			friend WebViewHost;
+			friend WebViewPool;
 
 		public:
 			using native_window_type = _GtkWidget*;
 
+			// Layout compatible with GPollFD (and with pollfd), the events are the ones of poll(2) (POLLIN == EPOLLIN and so on).
+			struct poll_fd_type
+			{
+				int            fd;
+				unsigned short events;
+				unsigned short revents;
+			};
+
+			struct poll_query_type
+			{
+				std::span<const poll_fd_type> fds;
+				// ms, -1 if there is no timeout
+				int timeout;
+			};
+
 		private:
+			constexpr static string_view_type post_message_function{"window.webkit.messageHandlers.external.postMessage"};
+			// The message is structured cloned, the `Uint8Array` arrives as a typed array.
+			constexpr static string_view_type post_binary_message_function{post_message_function};
+
+			// nullptr if the web view uses the default context
+			WebViewHost* host_;
+			// A GtkOffscreenWindow, nothing is shown on the screen (GTK still needs a display, e.g. Xvfb)
+			bool headless_;
+			// A hidden window is started (loaded, scripts run...) but it is not shown until `set_window_visible(true)`
+			bool window_is_visible_;
 			bool current_javascript_runnable_;
-			bool current_javascript_running_;
+			// Scripts evaluated before the page finished loading
+			std::vector<std::pair<string_type, eval_promise_type>> pending_javascript_;
 
 			native_window_type gtk_window_;
 			native_window_type gtk_web_view_;
 
+			// One of them is set
+			struct user_content_type
+			{
+				injection_id_type      id;
+				_WebKitUserScript*     script;
+				_WebKitUserStyleSheet* style_sheet;
+			};
+
+			// nullptr until the service starts
+			_WebKitUserContentManager* content_manager_;
+			// `inject_javascript_code_`, always the first script
+			_WebKitUserScript* bridge_script_;
+			// `injections_`, in the same order
+			std::vector<user_content_type> user_contents_;
+
+			// Does the work of the library itself (see `process_pending_work`) on every turn of the GLib loop,
+			// so that it does not matter who runs the loop (`iteration()`, `run()`, gtk_main or anyone else).
+			_GSource* loop_source_;
+
+			// See `prepare_poll`
+			std::vector<poll_fd_type> poll_fds_;
+			int                       poll_max_priority_;
+			bool                      poll_prepared_;
+
+			// Set while `run()` runs gtk_main, only this web view leaves the loop on `shutdown()`
+			// (a hidden web view of a pool or any web view destroyed while someone else runs the loop must not stop it).
+			bool runs_loop_;
+			// Waiting in a pool (see `WebViewPool`), the host does not count it as a running web view until it is handed out.
+			bool pooled_;
+
+			WebViewLinux(
+					WebViewHost*     host,
+					window_size_type window_width,
+					window_size_type window_height,
+					string_type&&    window_title,
+					bool             window_is_fixed,
+					bool             window_is_fullscreen,
+					bool             web_view_use_dev_tools,
+					string_type&&    index_url,
+					bool             headless);
+
 		public:
 			// using WebViewBase::WebViewBase;
 
@@ -36,21 +116,91 @@ namespace gal::web_view::impl
 					bool             window_is_fixed        = false,
 					bool             window_is_fullscreen   = false,
 					bool             web_view_use_dev_tools = false,
-					string_type&&    index_url              = string_type{default_index_url});
+					string_type&&    index_url              = string_type{default_index_url},
+					bool             headless               = false);
+
+			// The web view uses the context (and the loop) of the host, the host must outlive it.
+			WebViewLinux(
+					WebViewHost&     host,
+					window_size_type window_width,
+					window_size_type window_height,
+					string_type&&    window_title,
+					bool             window_is_fixed        = false,
+					bool             window_is_fullscreen   = false,
+					bool             web_view_use_dev_tools = false,
+					string_type&&    index_url              = string_type{default_index_url},
+					bool             headless               = false);
+
+			WebViewLinux(const WebViewLinux&)                    = delete;
+			WebViewLinux(WebViewLinux&&)                         = delete;
+			auto operator=(const WebViewLinux&) -> WebViewLinux& = delete;
+			auto operator=(WebViewLinux&&) -> WebViewLinux&      = delete;
+
+			~WebViewLinux() noexcept;
+
+			[[nodiscard]] constexpr auto headless() const noexcept -> bool { return headless_; }
+
+			// Can be called before `service_start()` (the window is never shown then) or at any time after it.
+			auto set_window_visible(bool visible) -> void;
+
+			[[nodiscard]] constexpr auto window_is_visible() const noexcept -> bool { return window_is_visible_; }
+
+			// For an external reactor (epoll, io_uring...), instead of `iteration()` / `run()`:
+			//	const auto [fds, timeout] = web_view.prepare_poll();
+			//	// wait until one of the fds is ready or the timeout expires (the fds may change every time, update the interest list)
+			//	web_view.dispatch_ready();
+			// Every call to `prepare_poll` must be followed by a call to `dispatch_ready` (on the same thread, which owns the GLib context in between).
+			[[nodiscard]] auto prepare_poll() -> poll_query_type;
+
+			// Dispatches everything which is ready (it finds out by itself which of the fds are ready), returns false once the web view has been shut down.
+			auto dispatch_ready() -> bool;
 
 		private:
+			// Shared by the web views of the host (if any), see `WebViewHost::acquire_user_script`.
+			[[nodiscard]] auto acquire_user_script(string_view_type javascript_code, InjectFrames frames, InjectTime time) const -> _WebKitUserScript*;
+
+			[[nodiscard]] auto acquire_user_style_sheet(string_view_type css, InjectFrames frames) const -> _WebKitUserStyleSheet*;
+
+			auto release(_WebKitUserScript* script) const -> void;
+
+			auto release(_WebKitUserStyleSheet* style_sheet) const -> void;
+
+			// A pooled web view does not keep `WebViewHost::run()` running.
+			auto set_pooled(bool pooled) -> void;
+
+			// The bridge first, then every script in order (scripts run in the order they were added).
+			auto install_user_scripts() const -> void;
+
+			// The bridge changed (a function has been bound).
+			auto post_inject(string_view_type inject_javascript_code) -> void;
+
+			auto do_add_injection(const injection_type& injection) -> void;
+
+			auto do_remove_injection(const injection_type& injection) -> void;
+
 			auto do_set_window_title(string_view_type title) const -> void;
 
 			auto do_set_window_fullscreen(bool to_fullscreen) const -> void;
 
 			[[nodiscard]] auto do_navigate(string_view_type target_url) const -> NavigateResult;
 
-			auto do_eval(string_view_type javascript_code) -> void;
+			auto do_eval(string_view_type javascript_code, eval_promise_type&& promise) -> void;
+
+			auto do_resolve(call_id_type id, bytes_view_type bytes) -> void;
+
+			// Thread safe
+			auto do_wake_up() const -> void;
+
+			auto do_register_scheme(string_view_type scheme) const -> void;
 
 			auto do_service_start() -> ServiceStartResult;
 
 			auto do_iteration() const -> bool;
 
+			auto do_iteration(std::chrono::milliseconds timeout) const -> bool;
+
+			auto do_run() -> void;
+
 			auto do_shutdown() -> void;
 		};
 	}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <webview/impl/v3/web_view_base.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <thread>
+#include <vector>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// A backend without any browser engine (and without any window), for unit tests and for measuring the overhead of the library itself.
+		// The javascript side is simulated:
+		//	`post_message` / `post_binary_message` play the role of the stubs (`window.external.<name>(arg)`)
+		//	the eval handler plays the role of the javascript engine, it receives every script and returns the result of it
+		// Navigations and scripts are recorded, and everything can be delayed by a simulated latency.
+		// It can be given any policy (see `WebViewTraits`), `WebViewMock` uses the default one.
+		template<typename Traits>
+		class BasicWebViewMock final : public WebViewBase<BasicWebViewMock<Traits>, Traits>
+		{
+			using base_type = WebViewBase<BasicWebViewMock, Traits>;
+
+			friend base_type;
+
+		public:
+			using typename base_type::allocator_type;
+			using typename base_type::bytes_view_type;
+			using typename base_type::call_id_type;
+			using typename base_type::eval_promise_type;
+			using typename base_type::eval_result_type;
+			using typename base_type::injection_id_type;
+			using typename base_type::injection_type;
+			using typename base_type::string_type;
+			using typename base_type::string_view_type;
+			using typename base_type::window_size_type;
+
+			using clock_type    = std::chrono::steady_clock;
+			using duration_type = clock_type::duration;
+
+			using eval_handler_type = std::function<auto(BasicWebViewMock& /* web_view */, string_view_type /* javascript_code */) -> eval_result_type>;
+
+			// The default eval handler, the result of a script is the script itself.
+			constexpr static auto echo = [](BasicWebViewMock&, const string_view_type javascript_code) -> eval_result_type { return {EvalResult::SUCCESS, string_type{javascript_code}}; };
+
+		private:
+			using base_type::current_url_;
+			using base_type::inject_javascript_code_;
+			using base_type::service_state_;
+			using base_type::window_is_fullscreen_;
+			using base_type::window_title_;
+
+			constexpr static string_view_type post_message_function{"window.__mock.postMessage"};
+			constexpr static string_view_type post_binary_message_function{post_message_function};
+
+			using event_type = std::function<auto(BasicWebViewMock&) -> void>;
+
+			eval_handler_type eval_handler_;
+			duration_type     latency_;
+
+			// ordered by the time they are due
+			std::vector<std::pair<clock_type::time_point, event_type>> events_;
+			// The scripts given to the engine which are not settled yet.
+			std::list<eval_promise_type> evaluating_;
+
+			std::vector<string_type>  navigations_;
+			std::vector<string_type>  evaluations_;
+			std::vector<call_id_type> binary_resolutions_;
+
+			// What the engine would inject into the next document.
+			std::vector<injection_id_type> installed_injections_;
+
+			std::atomic<std::size_t> wake_ups_;
+
+			// Like a real engine, nothing happens before the next `iteration()`.
+			auto schedule(event_type&& event) -> void
+			{
+				// the latency may have changed, keep them ordered
+				const auto due = clock_type::now() + latency_;
+				const auto it  = std::ranges::upper_bound(events_, due, {}, &decltype(events_)::value_type::first);
+				events_.emplace(it, due, std::move(event));
+			}
+
+			auto do_set_window_title(const string_view_type title) -> void { window_title_ = title; }
+
+			// `window_is_fullscreen_` is all there is
+			auto do_set_window_fullscreen([[maybe_unused]] const bool to_fullscreen) const noexcept -> void { (void)this; }
+
+			[[nodiscard]] auto do_navigate(const string_view_type target_url) -> NavigateResult
+			{
+				current_url_ = target_url;
+				navigations_.emplace_back(target_url);
+				return NavigateResult::SUCCESS;
+			}
+
+			auto do_eval(const string_view_type javascript_code, eval_promise_type&& promise) -> void
+			{
+				evaluations_.emplace_back(javascript_code);
+				schedule(
+						[code = evaluations_.back(), it = evaluating_.insert(evaluating_.end(), std::move(promise))](BasicWebViewMock& web_view) -> void
+						{
+							auto promise = std::move(*it);
+							web_view.evaluating_.erase(it);
+							promise.set_value(web_view.eval_handler_(web_view, code));
+						});
+			}
+
+			// The bytes are transferred on their own (like an engine that can pass them to a function), so the order of the replies can be checked.
+			auto do_resolve(const call_id_type id, const bytes_view_type bytes) -> void
+			{
+				binary_resolutions_.push_back(id);
+
+				auto code = this->make_string(base_type::reply_function_name);
+				code.append("([[");
+				json::append(code, id);
+				code.append(",1,");
+				base_type::append_bytes(code, bytes);
+				code.append("]])");
+				do_eval(code, eval_promise_type{});
+			}
+
+			// `schemes_` is all there is
+			auto do_register_scheme([[maybe_unused]] const string_view_type scheme) const noexcept -> void { (void)this; }
+
+			auto do_wake_up() noexcept -> void { wake_ups_.fetch_add(1, std::memory_order_relaxed); }
+
+			auto do_add_injection(const injection_type& injection) -> void { installed_injections_.push_back(injection.id); }
+
+			auto do_remove_injection(const injection_type& injection) -> void { std::erase(installed_injections_, injection.id); }
+
+			auto do_service_start() -> ServiceStartResult
+			{
+				for (const auto& injection: this->injections()) { do_add_injection(injection); }
+
+				service_state_ = ServiceStateResult::RUNNING;
+				this->navigate(current_url_);
+				return ServiceStartResult::SUCCESS;
+			}
+
+			// Runs every event that is due, if none of them is due it waits for the first one (like a blocking loop does).
+			auto do_iteration() -> bool
+			{
+				if (!events_.empty()) { return do_iteration(events_.front().first); }
+				return do_iteration(clock_type::now());
+			}
+
+			// Same as above, but it does not wait longer than `timeout`.
+			auto do_iteration(const std::chrono::milliseconds timeout) -> bool
+			{
+				const auto deadline = clock_type::now() + timeout;
+				if (!events_.empty()) { return do_iteration(std::min(events_.front().first, deadline)); }
+				return do_iteration(deadline);
+			}
+
+			auto do_iteration(const clock_type::time_point until) -> bool
+			{
+				if (service_state_ == ServiceStateResult::SHUTDOWN) { return false; }
+
+				std::this_thread::sleep_until(until);
+
+				const auto now = clock_type::now();
+				const auto end = std::ranges::upper_bound(events_, now, {}, &decltype(events_)::value_type::first);
+
+				// an event may schedule other events
+				std::vector<std::pair<clock_type::time_point, event_type>> due{std::make_move_iterator(events_.begin()), std::make_move_iterator(end)};
+				events_.erase(events_.begin(), end);
+				for (auto& [time, event]: due)
+				{
+					// nothing happens after the shutdown
+					if (service_state_ == ServiceStateResult::SHUTDOWN) { break; }
+					event(*this);
+				}
+
+				return service_state_ != ServiceStateResult::SHUTDOWN;
+			}
+
+			auto do_shutdown() noexcept -> void { service_state_ = ServiceStateResult::SHUTDOWN; }
+
+		public:
+			explicit BasicWebViewMock(
+					const window_size_type window_width           = base_type::default_window_width,
+					const window_size_type window_height          = base_type::default_window_height,
+					string_type&&          window_title           = {},
+					const bool             window_is_fixed        = false,
+					const bool             window_is_fullscreen   = false,
+					const bool             web_view_use_dev_tools = false,
+					string_type&&          index_url              = string_type{base_type::default_index_url},
+					const allocator_type&  allocator              = {})
+				: base_type{
+						  window_width,
+						  window_height,
+						  std::move(window_title),
+						  window_is_fixed,
+						  window_is_fullscreen,
+						  web_view_use_dev_tools,
+						  std::move(index_url),
+						  allocator},
+				  eval_handler_{echo},
+				  latency_{duration_type::zero()},
+				  wake_ups_{0}
+			{
+				// Every script is evaluated alone, so that the eval handler does not have to understand the batches
+				// (`set_eval_batch` turns them on, the eval handler is then given the batches as they are).
+				this->set_eval_batch({.max_bytes = 0, .max_delay = std::chrono::milliseconds{0}});
+
+				service_state_ = ServiceStateResult::INITIALIZED;
+			}
+
+			BasicWebViewMock(const BasicWebViewMock&)                    = delete;
+			BasicWebViewMock(BasicWebViewMock&&)                         = delete;
+			auto operator=(const BasicWebViewMock&) -> BasicWebViewMock& = delete;
+			auto operator=(BasicWebViewMock&&) -> BasicWebViewMock&      = delete;
+
+			~BasicWebViewMock() noexcept
+			{
+				this->stop_workers();
+				this->end_lifetime();
+
+				// like an engine, the scripts still running are settled (as failed ones) when the web view goes
+				for (auto& promise: std::exchange(evaluating_, {})) { promise.set_value({EvalResult::EVAL_FAILED, this->make_string("The web view is destroyed.")}); }
+			}
+
+			auto set_eval_handler(eval_handler_type&& handler) -> void { eval_handler_ = std::move(handler); }
+
+			// Both directions (scripts and messages) are delayed.
+			auto set_latency(const duration_type latency) noexcept -> void { latency_ = latency; }
+
+			// `window.external.<name>(argument)`, the message is delivered during the next `iteration()` (or later if there is a latency).
+			auto post_message(const call_id_type id, const string_view_type name, const string_view_type argument) -> void
+			{
+				auto message = this->make_string({});
+				json::append(message, id);
+				message.append(":").append(name).append(":").append(argument);
+				post_message(std::move(message));
+			}
+
+			// `window.webkit.messageHandlers.external.postMessage(message)` or the like, nothing is parsed by the mock.
+			auto post_message(string_type&& message) -> void
+			{
+				schedule([message = std::move(message)](BasicWebViewMock& web_view) -> void { web_view.receive_message(message); });
+			}
+
+			// `window.external.<name>(new Uint8Array(...))`
+			auto post_binary_message(const call_id_type id, const string_view_type name, const bytes_view_type bytes) -> void
+			{
+				schedule(
+						[id, name = string_type{name}, bytes = std::vector<std::byte>{bytes.begin(), bytes.end()}](BasicWebViewMock& web_view) -> void
+						{ web_view.receive_message(id, name, bytes); });
+			}
+
+			// One phase of a navigation, the mock does not load anything by itself (see `navigations()`).
+			// The event is delivered during the next `iteration()` (or later if there is a latency).
+			auto simulate_navigation_event(const NavigationEvent event, const string_view_type url, const string_view_type error = {}) -> void
+			{
+				schedule(
+						[event, url = string_type{url}, error = string_type{error}](BasicWebViewMock& web_view) -> void
+						{ web_view.navigation_changed(event, url, error); });
+			}
+
+			// Every url loaded (the index url included), in order.
+			[[nodiscard]] constexpr auto navigations() const noexcept -> const std::vector<string_type>& { return navigations_; }
+
+			// Every script evaluated (the replies included), in order.
+			[[nodiscard]] constexpr auto evaluations() const noexcept -> const std::vector<string_type>& { return evaluations_; }
+
+			// The calls resolved with bytes which were given to the mock as they are (and not in base64 within a reply script), in order.
+			[[nodiscard]] constexpr auto binary_resolutions() const noexcept -> const std::vector<call_id_type>& { return binary_resolutions_; }
+
+			// The bridge (and the stubs) injected into every page.
+			[[nodiscard]] constexpr auto injected_javascript_code() const noexcept -> string_view_type { return inject_javascript_code_; }
+
+			// The scripts / style sheets the engine has been given (see `add_script`), in order.
+			[[nodiscard]] constexpr auto installed_injections() const noexcept -> const std::vector<injection_id_type>& { return installed_injections_; }
+
+			[[nodiscard]] constexpr auto window_title() const noexcept -> string_view_type { return window_title_; }
+
+			[[nodiscard]] constexpr auto window_is_fullscreen() const noexcept -> bool { return window_is_fullscreen_; }
+
+			[[nodiscard]] auto wake_ups() const noexcept -> std::size_t { return wake_ups_.load(std::memory_order_relaxed); }
+
+			[[nodiscard]] constexpr auto pending_events() const noexcept -> std::size_t { return events_.size(); }
+
+			// How long a native loop would sleep before the queued scripts are due (see `set_eval_batch`), the mock does not wait for them.
+			using base_type::pending_work_timeout;
+
+			auto clear_records() noexcept -> void
+			{
+				navigations_.clear();
+				evaluations_.clear();
+				binary_resolutions_.clear();
+			}
+		};
+
+		using WebViewMock = BasicWebViewMock<WebViewTraits>;
+	}// namespace v3
+}// namespace gal::web_view::impl
@@ -0,0 +1,68 @@
+#pragma once
+
+#if defined(GAL_WEBVIEW_PLATFORM_LINUX)
+
+#include <webview/impl/v3/web_view_linux_v3.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		// Keeps `capacity` hidden web views started (web process spawned, bridge injected, index url loaded), so that opening one is only a matter of showing it:
+		//	WebViewPool pool{4, [&host] { auto wv = std::make_unique<WebViewLinux>(host, ...); wv->bind(...); return wv; }};
+		//	auto web_view = pool.acquire();
+		//	web_view->set_window_title(...);
+		//	web_view->set_window_visible(true);
+		// The pool is refilled on the loop when it is idle (GTK only lives on the loop thread), one web view at a time.
+		// The factory is called for every web view, it binds / injects what the web views need since they are started by the pool.
+		class WebViewPool
+		{
+		public:
+			using web_view_type = WebViewLinux;
+			using pointer_type  = std::unique_ptr<web_view_type>;
+			using factory_type  = std::function<auto() -> pointer_type>;
+			using size_type     = std::size_t;
+
+		private:
+			size_type    capacity_;
+			factory_type factory_;
+
+			std::vector<pointer_type> web_views_;
+			// the idle source refilling the pool, 0 if the pool is full
+			unsigned int refill_source_;
+
+			// A hidden and started web view, nullptr if it cannot be started.
+			[[nodiscard]] auto create() const -> pointer_type;
+
+			auto schedule_refill() -> void;
+
+			// Returns false once the pool is full.
+			auto refill() -> bool;
+
+		public:
+			WebViewPool(size_type capacity, factory_type&& factory);
+
+			WebViewPool(const WebViewPool&)                    = delete;
+			WebViewPool(WebViewPool&&)                         = delete;
+			auto operator=(const WebViewPool&) -> WebViewPool& = delete;
+			auto operator=(WebViewPool&&) -> WebViewPool&      = delete;
+
+			~WebViewPool() noexcept;
+
+			// A started (and still hidden) web view, whose index url has been loaded if the pool had time to load it.
+			// If the pool is empty the web view is created (and started) right now.
+			// Returns nullptr if the web view cannot be started.
+			[[nodiscard]] auto acquire() -> pointer_type;
+
+			[[nodiscard]] constexpr auto capacity() const noexcept -> size_type { return capacity_; }
+
+			// The web views ready to be handed out.
+			[[nodiscard]] constexpr auto size() const noexcept -> size_type { return web_views_.size(); }
+		};
+	}
+}
+
+#endif
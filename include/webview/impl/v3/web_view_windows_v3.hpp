@@ -3,6 +3,9 @@
 #if defined(GAL_WEBVIEW_PLATFORM_WINDOWS)
 
 	#include <webview/impl/v3/web_view_base.hpp>
+	#include <string>
+	#include <utility>
+	#include <vector>
 
 	#ifndef GAL_WEBVIEW_PUBLIC_WEBVIEW2
 struct ICoreWebView2Controller;
@@ -57,6 +60,8 @@ namespace gal::web_view::impl
 			};
 
 		private:
+			constexpr static string_view_type post_message_function{"window.chrome.webview.postMessage"};
+
 			bool					 is_temp_environment_;
 
 			dpi_type				 dpi_;
@@ -67,6 +72,9 @@ namespace gal::web_view::impl
 			web_view_controller_type web_view_controller_;
 			web_view_window_type	 web_view_window_;
 
+			// The id WebView2 gave to every injected script (empty until it is known), the bridge is `invalid_injection_id`.
+			std::vector<std::pair<injection_id_type, std::wstring>> script_ids_;
+
 		public:
 			// using WebViewBase::WebViewBase;
 
@@ -85,22 +93,43 @@ namespace gal::web_view::impl
 			WebViewWindows(WebViewWindows&&)						 = delete;
 			auto operator=(const WebViewWindows&) -> WebViewWindows& = delete;
 			auto operator=(WebViewWindows&&) -> WebViewWindows&		 = delete;
-			~WebViewWindows() noexcept;
 	#endif
+			~WebViewWindows() noexcept;
 
 		private:
+			// STARTED / REDIRECTED: NavigationStarting, COMMITTED: ContentLoading, FINISHED / FAILED: NavigationCompleted
+			auto			   add_navigation_handlers() -> void;
+
+			auto			   add_document_script(injection_id_type id, string_view_type javascript_code) -> void;
+
+			auto			   remove_document_script(injection_id_type id) -> void;
+
+			// The bridge changed (a function has been bound).
+			auto			   post_inject(string_view_type inject_javascript_code) -> void;
+
+			auto			   do_add_injection(const injection_type& injection) -> void;
+
+			auto			   do_remove_injection(const injection_type& injection) -> void;
+
 			auto			   do_set_window_title(string_view_type title) const -> void;
 
 			auto			   do_set_window_fullscreen(bool to_fullscreen) -> void;
 
 			[[nodiscard]] auto do_navigate(string_view_type target_url) const -> NavigateResult;
 
-			auto			   do_eval(string_view_type javascript_code) const -> void;
+			auto			   do_eval(string_view_type javascript_code, eval_promise_type&& promise) const -> void;
+
+			auto			   do_wake_up_after(std::chrono::milliseconds delay) const -> void;
+
+			// Thread safe
+			auto			   do_wake_up() const -> void;
 
 			auto			   do_service_start() -> ServiceStartResult;
 
 			[[nodiscard]] auto do_iteration() const -> bool;
 
+			[[nodiscard]] auto do_iteration(std::chrono::milliseconds timeout) const -> bool;
+
 			auto			   do_shutdown() const -> void;
 
 		public:
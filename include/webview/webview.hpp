@@ -1,10 +1,18 @@
 #pragma once
 
 #include <webview/impl/v3/web_view_linux_v3.hpp>
+#include <webview/impl/v3/web_view_pool_linux_v3.hpp>
 #include <webview/impl/v3/web_view_windows_v3.hpp>
 
 namespace gal::web_view
 {
+	template<typename T = void>
+	using Task = impl::Task<T>;
+
+	using impl::spawn;
+
+	namespace metrics = impl::metrics;
+
 	#if defined(GAL_WEBVIEW_PLATFORM_WINDOWS)
 
 	using WebView = impl::WebViewWindows;
@@ -12,6 +20,8 @@ namespace gal::web_view
 	#elif defined(GAL_WEBVIEW_PLATFORM_LINUX)
 
 	using WebView = impl::WebViewLinux;
+	using WebViewHost = impl::WebViewHost;
+	using WebViewPool = impl::WebViewPool;
 
 	#else
 
@@ -0,0 +1,194 @@
+#if defined(GAL_WEBVIEW_PLATFORM_LINUX)
+
+#include <webview/impl/v3/web_view_host_linux_v3.hpp>
+#include <webview/impl/v3/web_view_linux_v3.hpp>
+
+#include <gtk-3.0/gtk/gtk.h>
+#include <webkitgtk-4.0/webkit2/webkit2.h>
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace
+{
+	using web_view_host = gal::web_view::impl::WebViewHost;
+
+	[[nodiscard]] constexpr auto to_webkit(const web_view_host::CacheModel cache_model) noexcept -> WebKitCacheModel
+	{
+		switch (cache_model)
+		{
+			case web_view_host::CacheModel::DOCUMENT_VIEWER: { return WEBKIT_CACHE_MODEL_DOCUMENT_VIEWER; }
+			case web_view_host::CacheModel::DOCUMENT_BROWSER: { return WEBKIT_CACHE_MODEL_DOCUMENT_BROWSER; }
+			case web_view_host::CacheModel::WEB_BROWSER: { return WEBKIT_CACHE_MODEL_WEB_BROWSER; }
+		}
+		return WEBKIT_CACHE_MODEL_DOCUMENT_VIEWER;
+	}
+
+	[[nodiscard]] constexpr auto to_webkit(const gal::web_view::InjectFrames frames) noexcept -> WebKitUserContentInjectedFrames
+	{
+		return frames == gal::web_view::InjectFrames::ALL_FRAMES ? WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES : WEBKIT_USER_CONTENT_INJECT_TOP_FRAME;
+	}
+
+	[[nodiscard]] constexpr auto to_webkit(const gal::web_view::InjectTime time) noexcept -> WebKitUserScriptInjectionTime
+	{
+		return time == gal::web_view::InjectTime::DOCUMENT_END ? WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_END : WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START;
+	}
+
+	// 's' / 'c' + frames + time, followed by the content
+	[[nodiscard]] auto user_content_key(
+			const bool                            style_sheet,
+			const web_view_host::string_view_type code,
+			const gal::web_view::InjectFrames     frames,
+			const gal::web_view::InjectTime       time) -> web_view_host::string_type
+	{
+		web_view_host::string_type key{};
+		key.reserve(1 + code.size());
+		key.push_back(static_cast<char>((style_sheet ? 'c' : 's') + 2 * static_cast<int>(frames) + 4 * static_cast<int>(time)));
+		key.append(code);
+		return key;
+	}
+
+	[[nodiscard]] auto to_c_string(const web_view_host::string_type& string) noexcept -> const gchar* { return string.empty() ? nullptr : string.c_str(); }
+}// namespace
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		WebViewHost::WebViewHost()
+			: WebViewHost{options_type{}} {}
+
+		WebViewHost::WebViewHost(options_type options)
+			: options_{std::move(options)},
+			  web_context_{nullptr},
+			  running_views_{0},
+			  runs_loop_{false}
+		{
+			if (gtk_init_check(nullptr, nullptr) == FALSE) { return; }
+
+			auto* website_data_manager =
+					options_.data_directory.empty() && options_.cache_directory.empty()
+							? webkit_website_data_manager_new_ephemeral()
+							: webkit_website_data_manager_new(
+									  "base-data-directory",
+									  to_c_string(options_.data_directory),
+									  "base-cache-directory",
+									  to_c_string(options_.cache_directory),
+									  nullptr);
+
+			web_context_ = webkit_web_context_new_with_website_data_manager(website_data_manager);
+			g_object_unref(website_data_manager);
+
+			webkit_web_context_set_cache_model(web_context_, to_webkit(options_.cache_model));
+		}
+
+		WebViewHost::~WebViewHost() noexcept
+		{
+			assert(views_.empty() && "The host must outlive its web views!");
+
+			for (const auto& [key, content]: user_contents_)
+			{
+				if (content.script) { webkit_user_script_unref(content.script); }
+				if (content.style_sheet) { webkit_user_style_sheet_unref(content.style_sheet); }
+			}
+
+			if (web_context_) { g_object_unref(web_context_); }
+		}
+
+		auto WebViewHost::attach(WebViewLinux& web_view) -> void { views_.push_back(&web_view); }
+
+		auto WebViewHost::detach(WebViewLinux& web_view) -> void { std::erase(views_, &web_view); }
+
+		auto WebViewHost::related_view(const WebViewLinux& web_view) const noexcept -> _GtkWidget*
+		{
+			if (options_.process_model != ProcessModel::SHARED) { return nullptr; }
+
+			// a web process lives as long as one of the web views using it
+			const auto it = std::ranges::find_if(
+					views_,
+					[&web_view](const WebViewLinux* other) -> bool
+					{ return other != &web_view && other->gtk_web_view_ && other->service_state() == ServiceStateResult::RUNNING; });
+			return it == views_.end() ? nullptr : (*it)->gtk_web_view_;
+		}
+
+		auto WebViewHost::make_user_script(const string_view_type javascript_code, const InjectFrames frames, const InjectTime time) -> _WebKitUserScript*
+		{
+			const string_type code{javascript_code};
+			return webkit_user_script_new(code.c_str(), to_webkit(frames), to_webkit(time), nullptr, nullptr);
+		}
+
+		auto WebViewHost::make_user_style_sheet(const string_view_type css, const InjectFrames frames) -> _WebKitUserStyleSheet*
+		{
+			const string_type code{css};
+			return webkit_user_style_sheet_new(code.c_str(), to_webkit(frames), WEBKIT_USER_STYLE_LEVEL_USER, nullptr, nullptr);
+		}
+
+		auto WebViewHost::acquire_user_script(const string_view_type javascript_code, const InjectFrames frames, const InjectTime time) -> _WebKitUserScript*
+		{
+			auto [it, inserted] = user_contents_.try_emplace(user_content_key(false, javascript_code, frames, time), user_content_type{nullptr, nullptr, 0});
+			if (inserted) { it->second.script = make_user_script(javascript_code, frames, time); }
+
+			++it->second.users;
+			return it->second.script;
+		}
+
+		auto WebViewHost::acquire_user_style_sheet(const string_view_type css, const InjectFrames frames) -> _WebKitUserStyleSheet*
+		{
+			auto [it, inserted] = user_contents_.try_emplace(user_content_key(true, css, frames, InjectTime::DOCUMENT_START), user_content_type{nullptr, nullptr, 0});
+			if (inserted) { it->second.style_sheet = make_user_style_sheet(css, frames); }
+
+			++it->second.users;
+			return it->second.style_sheet;
+		}
+
+		auto WebViewHost::release(const _WebKitUserScript* script) -> void
+		{
+			const auto it = std::ranges::find_if(user_contents_, [script](const auto& pair) -> bool { return pair.second.script == script; });
+			assert(it != user_contents_.end() && "Unknown script!");
+
+			// the content managers using it keep their own references
+			if (--it->second.users == 0)
+			{
+				webkit_user_script_unref(it->second.script);
+				user_contents_.erase(it);
+			}
+		}
+
+		auto WebViewHost::release(const _WebKitUserStyleSheet* style_sheet) -> void
+		{
+			const auto it = std::ranges::find_if(user_contents_, [style_sheet](const auto& pair) -> bool { return pair.second.style_sheet == style_sheet; });
+			assert(it != user_contents_.end() && "Unknown style sheet!");
+
+			if (--it->second.users == 0)
+			{
+				webkit_user_style_sheet_unref(it->second.style_sheet);
+				user_contents_.erase(it);
+			}
+		}
+
+		auto WebViewHost::on_service_start() -> void { ++running_views_; }
+
+		auto WebViewHost::on_shutdown() -> void
+		{
+			assert(running_views_ != 0);
+
+			if (--running_views_ == 0) { quit(); }
+		}
+
+		auto WebViewHost::run() -> void
+		{
+			if (!initialized() || running_views_ == 0) { return; }
+
+			const auto was_running_loop = std::exchange(runs_loop_, true);
+			gtk_main();
+			runs_loop_ = was_running_loop;
+		}
+
+		auto WebViewHost::quit() -> void
+		{
+			if (runs_loop_) { gtk_main_quit(); }
+		}
+	}
+}
+
+#endif
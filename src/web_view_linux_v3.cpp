@@ -4,7 +4,305 @@
 
 #include <gtk-3.0/gtk/gtk.h>
 #include <webkitgtk-4.0/webkit2/webkit2.h>
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using web_view_linux = gal::web_view::impl::WebViewLinux;
+
+	// The web view which owns a WebKitWebView (cleared before it goes away).
+	constexpr const char* web_view_key = "gal-web-view";
+	// Set on a WebKitWebContext once the scheme is registered on it.
+	constexpr std::string_view scheme_key_prefix{"gal-web-view-scheme:"};
+
+	struct js_value_deleter
+	{
+		auto operator()(JSCValue* value) const noexcept -> void { g_object_unref(value); }
+	};
+
+	struct g_free_deleter
+	{
+		auto operator()(gchar* string) const noexcept -> void { g_free(string); }
+	};
+
+	using js_value_pointer = std::unique_ptr<JSCValue, js_value_deleter>;
+	using g_string_pointer = std::unique_ptr<gchar, g_free_deleter>;
+
+	struct binary_message
+	{
+		web_view_linux::call_id_type    id;
+		g_string_pointer                name;
+		// keep the typed array alive
+		js_value_pointer                owner;
+		std::pmr::vector<std::byte>     copied;
+		web_view_linux::bytes_view_type bytes;
+	};
+
+	// [id, name, Uint8Array], a copy (if any) is allocated from the arena of the messages
+	[[nodiscard]] auto read_binary_message(JSCValue* js_value, std::pmr::memory_resource& resource) -> binary_message
+	{
+		const js_value_pointer id_value{jsc_value_object_get_property_at_index(js_value, 0)};
+		const js_value_pointer name_value{jsc_value_object_get_property_at_index(js_value, 1)};
+
+		binary_message message{
+				.id     = static_cast<web_view_linux::call_id_type>(jsc_value_to_double(id_value.get())),
+				.name   = g_string_pointer{jsc_value_to_string(name_value.get())},
+				.owner  = js_value_pointer{jsc_value_object_get_property_at_index(js_value, 2)},
+				.copied = std::pmr::vector<std::byte>{&resource},
+				.bytes  = {}};
+
+	#if WEBKIT_CHECK_VERSION(2, 38, 0)
+		// The data is owned by the typed array, nothing is copied.
+		if (jsc_value_is_typed_array(message.owner.get()))
+		{
+			gsize       size = 0;
+			const auto* data = static_cast<const std::byte*>(jsc_value_typed_array_get_data(message.owner.get(), &size));
+			message.bytes    = {data, size};
+		}
+	#else
+		// No typed array API, read it element by element.
+		const js_value_pointer length_value{jsc_value_object_get_property(message.owner.get(), "length")};
+		message.copied.resize(static_cast<std::size_t>(jsc_value_to_int32(length_value.get())));
+		for (guint i = 0; i < message.copied.size(); ++i)
+		{
+			const js_value_pointer byte_value{jsc_value_object_get_property_at_index(message.owner.get(), i)};
+			message.copied[i] = static_cast<std::byte>(jsc_value_to_int32(byte_value.get()));
+		}
+		message.bytes = message.copied;
+	#endif
+
+		return message;
+	}
+
+	auto run_javascript(
+			WebKitWebView*                     web_view,
+			const web_view_linux::string_view_type javascript_code,
+			web_view_linux::eval_promise_type&&    promise) -> void
+	{
+		using gal::web_view::EvalResult;
+
+		// The ownership of the promise is transferred to the callback.
+		auto* arg = new web_view_linux::eval_promise_type{std::move(promise)};
+
+	#if WEBKIT_CHECK_VERSION(2, 40, 0)
+		webkit_web_view_evaluate_javascript(
+				web_view,
+				javascript_code.data(),
+				static_cast<gssize>(javascript_code.size()),
+				nullptr,
+				nullptr,
+				nullptr,
+				+[](
+				GObject*       source_object,
+				GAsyncResult*  result,
+				const gpointer data) -> void
+				{
+					const std::unique_ptr<web_view_linux::eval_promise_type> p{static_cast<web_view_linux::eval_promise_type*>(data)};
+
+					GError* error    = nullptr;
+					auto*   js_value = webkit_web_view_evaluate_javascript_finish(WEBKIT_WEB_VIEW(source_object), result, &error);
+					if (!js_value)
+					{
+						p->set_value({EvalResult::EVAL_FAILED, error ? error->message : ""});
+						if (error) { g_error_free(error); }
+						return;
+					}
+
+					auto* value = jsc_value_is_string(js_value) ? jsc_value_to_string(js_value) : jsc_value_to_json(js_value, 0);
+					p->set_value({EvalResult::SUCCESS, value ? value : ""});
+					g_free(value);
+					g_object_unref(js_value);
+				},
+				arg);
+	#else
+		// webkit_web_view_run_javascript requires a null-terminated string
+		const web_view_linux::string_type code{javascript_code};
+		webkit_web_view_run_javascript(
+				web_view,
+				code.c_str(),
+				nullptr,
+				+[](
+				GObject*       source_object,
+				GAsyncResult*  result,
+				const gpointer data) -> void
+				{
+					const std::unique_ptr<web_view_linux::eval_promise_type> p{static_cast<web_view_linux::eval_promise_type*>(data)};
+
+					GError* error     = nullptr;
+					auto*   js_result = webkit_web_view_run_javascript_finish(WEBKIT_WEB_VIEW(source_object), result, &error);
+					if (!js_result)
+					{
+						p->set_value({EvalResult::EVAL_FAILED, error ? error->message : ""});
+						if (error) { g_error_free(error); }
+						return;
+					}
+
+					auto* js_value = webkit_javascript_result_get_js_value(js_result);
+					auto* value    = jsc_value_is_string(js_value) ? jsc_value_to_string(js_value) : jsc_value_to_json(js_value, 0);
+					p->set_value({EvalResult::SUCCESS, value ? value : ""});
+					g_free(value);
+					webkit_javascript_result_unref(js_result);
+				},
+				arg);
+	#endif
+	}
+
+	using gal::web_view::impl::AssetRegistry;
+
+	// The body of the response, nullptr if it cannot be read.
+	[[nodiscard]] auto open_asset_stream(const AssetRegistry::response_type& response) -> GInputStream*
+	{
+		if (!response.with_body || response.length == 0) { return g_memory_input_stream_new(); }
+
+		const auto& asset = *response.asset;
+		if (asset.kind == AssetRegistry::Kind::MEMORY)
+		{
+			const auto bytes = asset.bytes.subspan(response.offset, response.length);
+			// The bytes are not copied, the GBytes shares the ownership of them (if they are not static).
+			auto* const g_bytes = asset.owner
+			                              ? g_bytes_new_with_free_func(
+			                                        bytes.data(),
+			                                        bytes.size(),
+			                                        +[](const gpointer owner) -> void { delete static_cast<std::shared_ptr<const void>*>(owner); },
+			                                        new std::shared_ptr<const void>{asset.owner})
+			                              : g_bytes_new_static(bytes.data(), bytes.size());
+			auto* const stream = g_memory_input_stream_new_from_bytes(g_bytes);
+			g_bytes_unref(g_bytes);
+			if (asset.encoding.empty()) { return stream; }
+
+			// Pre-compressed (gal_webview_embed_assets), it is decompressed while it is read.
+			auto* const decompressor     = g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+			auto* const converted_stream = g_converter_input_stream_new(stream, G_CONVERTER(decompressor));
+			g_object_unref(decompressor);
+			g_object_unref(stream);
+			return converted_stream;
+		}
+
+		auto* const file   = g_file_new_for_path(asset.path.c_str());
+		auto* const stream = g_file_read(file, nullptr, nullptr);
+		g_object_unref(file);
+		if (!stream) { return nullptr; }
+
+		// The whole file is streamed.
+		if (response.offset == 0 && response.length == asset.size) { return G_INPUT_STREAM(stream); }
+
+		// A range is usually small (media seeking), it is read into memory.
+		auto* const data = static_cast<guchar*>(g_malloc(static_cast<gsize>(response.length)));
+		gsize       read = 0;
+		const auto  ok   = g_seekable_seek(G_SEEKABLE(stream), static_cast<goffset>(response.offset), G_SEEK_SET, nullptr, nullptr) &&
+		                   g_input_stream_read_all(G_INPUT_STREAM(stream), data, static_cast<gsize>(response.length), &read, nullptr, nullptr);
+		g_object_unref(stream);
+		if (!ok || read != response.length)
+		{
+			g_free(data);
+			return nullptr;
+		}
+
+		auto* const g_bytes      = g_bytes_new_take(data, read);
+		auto* const range_stream = g_memory_input_stream_new_from_bytes(g_bytes);
+		g_bytes_unref(g_bytes);
+		return range_stream;
+	}
+
+	auto respond_uri_scheme_request(WebKitURISchemeRequest* request, const AssetRegistry& registry) -> void
+	{
+		const auto nullable = [](const char* string) -> AssetRegistry::string_view_type { return string ? string : ""; };
+
+		AssetRegistry::request_type asset_request{
+				.method        = "GET",
+				.path          = nullable(webkit_uri_scheme_request_get_path(request)),
+				.range         = {},
+				.if_none_match = {}};
+	#if WEBKIT_CHECK_VERSION(2, 36, 0)
+		asset_request.method = nullable(webkit_uri_scheme_request_get_http_method(request));
+		if (auto* headers = webkit_uri_scheme_request_get_http_headers(request))
+		{
+			asset_request.range         = nullable(soup_message_headers_get_one(headers, "Range"));
+			asset_request.if_none_match = nullable(soup_message_headers_get_one(headers, "If-None-Match"));
+		}
+	#endif
+
+		const auto response = registry.respond(asset_request);
+		auto*      stream   = response.asset ? open_asset_stream(response) : nullptr;
+		if (!stream)
+		{
+			auto* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, response.status == 405 ? "method not allowed" : "not found");
+			webkit_uri_scheme_request_finish_error(request, error);
+			g_error_free(error);
+			return;
+		}
+
+		// The decoded size of an encoded asset is unknown
+		const auto is_encoded    = !response.asset->encoding.empty();
+		const auto stream_length = !response.with_body ? 0 : is_encoded ? -1 : static_cast<gint64>(response.length);
+
+	#if WEBKIT_CHECK_VERSION(2, 36, 0)
+		const auto to_string = [](const AssetRegistry::size_type value) -> AssetRegistry::string_type
+		{
+			char       buffer[24];
+			const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			return {buffer, result.ptr};
+		};
+
+		auto* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+		soup_message_headers_append(headers, "ETag", response.asset->etag.c_str());
+		soup_message_headers_append(headers, "Accept-Ranges", is_encoded ? "none" : "bytes");
+		if (!is_encoded) { soup_message_headers_append(headers, "Content-Length", to_string(response.length).c_str()); }
+		if (response.status == 206)
+		{
+			const auto range = AssetRegistry::string_type{"bytes "}
+			                           .append(to_string(response.offset))
+			                           .append("-")
+			                           .append(to_string(response.offset + response.length - 1))
+			                           .append("/")
+			                           .append(to_string(response.asset->size));
+			soup_message_headers_append(headers, "Content-Range", range.c_str());
+		}
+		else if (response.status == 416) { soup_message_headers_append(headers, "Content-Range", AssetRegistry::string_type{"bytes */"}.append(to_string(response.asset->size)).c_str()); }
+
+		auto* scheme_response = webkit_uri_scheme_response_new(stream, stream_length);
+		webkit_uri_scheme_response_set_status(scheme_response, static_cast<guint>(response.status), nullptr);
+		webkit_uri_scheme_response_set_content_type(scheme_response, response.asset->mime_type.c_str());
+		// transfer full
+		webkit_uri_scheme_response_set_http_headers(scheme_response, headers);
+		webkit_uri_scheme_request_finish_with_response(request, scheme_response);
+		g_object_unref(scheme_response);
+	#else
+		// No status / headers, the whole asset is always sent.
+		webkit_uri_scheme_request_finish(request, stream, stream_length, response.asset->mime_type.c_str());
+	#endif
+
+		g_object_unref(stream);
+	}
+
+	// A GSource carrying the web view
+	struct loop_source
+	{
+		GSource         source;
+		web_view_linux* web_view;
+	};
+
+	static_assert(sizeof(web_view_linux::poll_fd_type) == sizeof(GPollFD));
+	static_assert(offsetof(web_view_linux::poll_fd_type, fd) == offsetof(GPollFD, fd));
+	static_assert(offsetof(web_view_linux::poll_fd_type, events) == offsetof(GPollFD, events));
+	static_assert(offsetof(web_view_linux::poll_fd_type, revents) == offsetof(GPollFD, revents));
+
+	[[nodiscard]] auto to_poll_timeout(const std::chrono::milliseconds timeout) -> gint
+	{
+		if (timeout == std::chrono::milliseconds::max()) { return -1; }
+		return static_cast<gint>(std::min<std::chrono::milliseconds::rep>(timeout.count(), std::numeric_limits<gint>::max()));
+	}
+}// namespace
 
 namespace gal::web_view::impl
 {
@@ -17,7 +315,53 @@ namespace gal::web_view::impl
 				const bool             window_is_fixed,
 				const bool             window_is_fullscreen,
 				const bool             web_view_use_dev_tools,
-				string_type&&          index_url)
+				string_type&&          index_url,
+				const bool             headless)
+			: WebViewLinux{
+					  nullptr,
+					  window_width,
+					  window_height,
+					  std::move(window_title),
+					  window_is_fixed,
+					  window_is_fullscreen,
+					  web_view_use_dev_tools,
+					  std::move(index_url),
+					  headless} {}
+
+		WebViewLinux::WebViewLinux(
+				WebViewHost&           host,
+				const window_size_type window_width,
+				const window_size_type window_height,
+				string_type&&          window_title,
+				const bool             window_is_fixed,
+				const bool             window_is_fullscreen,
+				const bool             web_view_use_dev_tools,
+				string_type&&          index_url,
+				const bool             headless)
+			: WebViewLinux{
+					  &host,
+					  window_width,
+					  window_height,
+					  std::move(window_title),
+					  window_is_fixed,
+					  window_is_fullscreen,
+					  web_view_use_dev_tools,
+					  std::move(index_url),
+					  headless}
+		{
+			host.attach(*this);
+		}
+
+		WebViewLinux::WebViewLinux(
+				WebViewHost*           host,
+				const window_size_type window_width,
+				const window_size_type window_height,
+				string_type&&          window_title,
+				const bool             window_is_fixed,
+				const bool             window_is_fullscreen,
+				const bool             web_view_use_dev_tools,
+				string_type&&          index_url,
+				const bool             headless)
 			: WebViewBase{
 					  window_width,
 					  window_height,
@@ -26,19 +370,50 @@ namespace gal::web_view::impl
 					  window_is_fullscreen,
 					  web_view_use_dev_tools,
 					  std::move(index_url)},
+			  host_{host},
+			  headless_{headless},
+			  window_is_visible_{true},
 			  current_javascript_runnable_{false},
-			  current_javascript_running_{false},
 			  gtk_window_{nullptr},
-			  gtk_web_view_{nullptr}
+			  gtk_web_view_{nullptr},
+			  content_manager_{nullptr},
+			  bridge_script_{nullptr},
+			  loop_source_{nullptr},
+			  poll_max_priority_{0},
+			  poll_prepared_{false},
+			  runs_loop_{false},
+			  pooled_{false}
 		{
-			inject_javascript_code_ = "window.external={" GAL_WEBVIEW_METHOD_NAME ":arg=>window.webkit.messageHandlers.external.postMessage(arg)};";
-
 			if (gtk_init_check(nullptr, nullptr) == FALSE) { return; }
 
+			// prepare: how long the loop may sleep / check: after it woke up / dispatch: only called if one of them returned TRUE
+			static GSourceFuncs loop_source_funcs{
+					.prepare = +[](GSource* source, gint* timeout) -> gboolean
+					{
+						const auto pending = reinterpret_cast<loop_source*>(source)->web_view->pending_work_timeout();
+						*timeout           = to_poll_timeout(pending);
+						return pending == std::chrono::milliseconds::zero();
+					},
+					.check = +[](GSource* source) -> gboolean
+					{ return reinterpret_cast<loop_source*>(source)->web_view->pending_work_timeout() == std::chrono::milliseconds::zero(); },
+					.dispatch = +[](GSource* source, [[maybe_unused]] GSourceFunc callback, [[maybe_unused]] const gpointer arg) -> gboolean
+					{
+						reinterpret_cast<loop_source*>(source)->web_view->process_pending_work();
+						return G_SOURCE_CONTINUE;
+					},
+					.finalize         = nullptr,
+					.closure_callback = nullptr,
+					.closure_marshal  = nullptr};
+
+			loop_source_ = g_source_new(&loop_source_funcs, sizeof(loop_source));
+			reinterpret_cast<loop_source*>(loop_source_)->web_view = this;
+			g_source_attach(loop_source_, nullptr);
+
 			// Initialize GTK window
-			gtk_window_ = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+			gtk_window_ = headless_ ? gtk_offscreen_window_new() : gtk_window_new(GTK_WINDOW_TOPLEVEL);
 
-			if (window_is_fixed_) { gtk_widget_set_size_request(gtk_window_, static_cast<gint>(window_width_), static_cast<gint>(window_height_)); }
+			// the size of an offscreen window never changes
+			if (window_is_fixed_ || headless_) { gtk_widget_set_size_request(gtk_window_, static_cast<gint>(window_width_), static_cast<gint>(window_height_)); }
 			else { gtk_window_set_default_size(GTK_WINDOW(gtk_window_), static_cast<gint>(window_width_), static_cast<gint>(window_height_)); }
 
 			gtk_window_set_resizable(GTK_WINDOW(gtk_window_), !window_is_fixed_);
@@ -47,6 +422,188 @@ namespace gal::web_view::impl
 			service_state_ = ServiceStateResult::INITIALIZED;
 		}
 
+		WebViewLinux::~WebViewLinux() noexcept
+		{
+			stop_workers();
+			// WebKit settles the scripts which are still running once the web view is gone
+			end_lifetime();
+			if (poll_prepared_) { g_main_context_release(nullptr); }
+			// the web view goes with it (and its web process if it is the last one using it),
+			// the "destroy" handler must not `shutdown()` a web view which is being destroyed
+			if (gtk_window_)
+			{
+				// the requests of its custom schemes may still come
+				if (gtk_web_view_) { g_object_set_data(G_OBJECT(gtk_web_view_), web_view_key, nullptr); }
+				g_signal_handlers_disconnect_by_data(gtk_window_, this);
+				gtk_widget_destroy(gtk_window_);
+			}
+			for (const auto& content: user_contents_)
+			{
+				if (content.script) { release(content.script); }
+				else { release(content.style_sheet); }
+			}
+			if (bridge_script_) { release(bridge_script_); }
+			if (content_manager_) { g_object_unref(content_manager_); }
+			if (host_)
+			{
+				if (service_state_ == ServiceStateResult::RUNNING && !pooled_) { host_->on_shutdown(); }
+				host_->detach(*this);
+			}
+			if (loop_source_)
+			{
+				g_source_destroy(loop_source_);
+				g_source_unref(loop_source_);
+			}
+		}
+
+		auto WebViewLinux::set_window_visible(const bool visible) -> void
+		{
+			window_is_visible_ = visible;
+			if (service_state_ != ServiceStateResult::RUNNING || headless_) { return; }
+
+			if (window_is_visible_) { gtk_window_present(GTK_WINDOW(gtk_window_)); }
+			else { gtk_widget_hide(gtk_window_); }
+		}
+
+		auto WebViewLinux::prepare_poll() -> poll_query_type
+		{
+			assert(!poll_prepared_ && "dispatch_ready must be called after prepare_poll!");
+
+			[[maybe_unused]] const auto acquired = g_main_context_acquire(nullptr);
+			assert(acquired && "The GLib context is owned by another thread!");
+			poll_prepared_ = true;
+
+			// the loop source does the work of the library here
+			g_main_context_prepare(nullptr, &poll_max_priority_);
+
+			gint timeout = -1;
+			if (poll_fds_.empty()) { poll_fds_.resize(8); }
+			while (true)
+			{
+				const auto size = g_main_context_query(nullptr, poll_max_priority_, &timeout, reinterpret_cast<GPollFD*>(poll_fds_.data()), static_cast<gint>(poll_fds_.size()));
+				if (static_cast<std::size_t>(size) <= poll_fds_.size())
+				{
+					poll_fds_.resize(static_cast<std::size_t>(size));
+					break;
+				}
+				poll_fds_.resize(static_cast<std::size_t>(size));
+			}
+
+			return {.fds = poll_fds_, .timeout = timeout};
+		}
+
+		auto WebViewLinux::dispatch_ready() -> bool
+		{
+			if (!poll_prepared_) { return service_state_ != ServiceStateResult::SHUTDOWN; }
+
+			// the reactor only knows that (at least) one of them is ready
+			g_poll(reinterpret_cast<GPollFD*>(poll_fds_.data()), static_cast<guint>(poll_fds_.size()), 0);
+
+			if (g_main_context_check(nullptr, poll_max_priority_, reinterpret_cast<GPollFD*>(poll_fds_.data()), static_cast<gint>(poll_fds_.size())))
+			{
+				g_main_context_dispatch(nullptr);
+			}
+
+			g_main_context_release(nullptr);
+			poll_prepared_ = false;
+
+			return service_state_ != ServiceStateResult::SHUTDOWN;
+		}
+
+		auto WebViewLinux::acquire_user_script(const string_view_type javascript_code, const InjectFrames frames, const InjectTime time) const -> _WebKitUserScript*
+		{
+			if (host_) { return host_->acquire_user_script(javascript_code, frames, time); }
+			return WebViewHost::make_user_script(javascript_code, frames, time);
+		}
+
+		auto WebViewLinux::acquire_user_style_sheet(const string_view_type css, const InjectFrames frames) const -> _WebKitUserStyleSheet*
+		{
+			if (host_) { return host_->acquire_user_style_sheet(css, frames); }
+			return WebViewHost::make_user_style_sheet(css, frames);
+		}
+
+		auto WebViewLinux::release(_WebKitUserScript* script) const -> void
+		{
+			if (host_) { host_->release(script); }
+			else { webkit_user_script_unref(script); }
+		}
+
+		auto WebViewLinux::release(_WebKitUserStyleSheet* style_sheet) const -> void
+		{
+			if (host_) { host_->release(style_sheet); }
+			else { webkit_user_style_sheet_unref(style_sheet); }
+		}
+
+		auto WebViewLinux::install_user_scripts() const -> void
+		{
+			// the objects are reused, nothing is parsed again
+			webkit_user_content_manager_remove_all_scripts(content_manager_);
+			webkit_user_content_manager_add_script(content_manager_, bridge_script_);
+			for (const auto& content: user_contents_)
+			{
+				if (content.script) { webkit_user_content_manager_add_script(content_manager_, content.script); }
+			}
+		}
+
+		auto WebViewLinux::post_inject(const string_view_type inject_javascript_code) -> void
+		{
+			// the bridge is created when the service starts
+			if (!content_manager_) { return; }
+
+			release(bridge_script_);
+			bridge_script_ = acquire_user_script(inject_javascript_code, InjectFrames::TOP_FRAME, InjectTime::DOCUMENT_START);
+			// it must stay the first one
+			install_user_scripts();
+		}
+
+		auto WebViewLinux::do_add_injection(const injection_type& injection) -> void
+		{
+			if (injection.style_sheet)
+			{
+				auto* style_sheet = acquire_user_style_sheet(injection.code, injection.frames);
+				user_contents_.push_back({.id = injection.id, .script = nullptr, .style_sheet = style_sheet});
+				webkit_user_content_manager_add_style_sheet(content_manager_, style_sheet);
+			}
+			else
+			{
+				auto* script = acquire_user_script(injection.code, injection.frames, injection.time);
+				user_contents_.push_back({.id = injection.id, .script = script, .style_sheet = nullptr});
+				webkit_user_content_manager_add_script(content_manager_, script);
+			}
+		}
+
+		auto WebViewLinux::do_remove_injection(const injection_type& injection) -> void
+		{
+			const auto it = std::ranges::find(user_contents_, injection.id, &user_content_type::id);
+			assert(it != user_contents_.end() && "Unknown injection!");
+
+			const auto content = *it;
+			user_contents_.erase(it);
+
+			if (content.script)
+			{
+	#if WEBKIT_CHECK_VERSION(2, 32, 0)
+				webkit_user_content_manager_remove_script(content_manager_, content.script);
+	#else
+				install_user_scripts();
+	#endif
+				release(content.script);
+			}
+			else
+			{
+	#if WEBKIT_CHECK_VERSION(2, 32, 0)
+				webkit_user_content_manager_remove_style_sheet(content_manager_, content.style_sheet);
+	#else
+				webkit_user_content_manager_remove_all_style_sheets(content_manager_);
+				for (const auto& other: user_contents_)
+				{
+					if (other.style_sheet) { webkit_user_content_manager_add_style_sheet(content_manager_, other.style_sheet); }
+				}
+	#endif
+				release(content.style_sheet);
+			}
+		}
+
 		auto WebViewLinux::do_set_window_title(const string_view_type title) const -> void { gtk_window_set_title(GTK_WINDOW(gtk_window_), title.data()); }
 
 		auto WebViewLinux::do_set_window_fullscreen(const bool to_fullscreen) const -> void
@@ -61,39 +618,127 @@ namespace gal::web_view::impl
 			return NavigateResult::SUCCESS;
 		}
 
-		auto WebViewLinux::do_eval(const string_view_type javascript_code) -> void
+		auto WebViewLinux::do_eval(const string_view_type javascript_code, eval_promise_type&& promise) -> void
 		{
-			while (!current_javascript_runnable_) { g_main_context_iteration(nullptr, TRUE); }
+			if (!current_javascript_runnable_)
+			{
+				pending_javascript_.emplace_back(string_type{javascript_code}, std::move(promise));
+				return;
+			}
 
-			current_javascript_running_ = true;
-			webkit_web_view_run_javascript(
-					WEBKIT_WEB_VIEW(gtk_web_view_),
-					javascript_code.data(),
-					nullptr,
-					+[](
-					[[maybe_unused]] GObject*      source_object,
-					[[maybe_unused]] GAsyncResult* result,
-					const gpointer                 arg) -> void
+			run_javascript(WEBKIT_WEB_VIEW(gtk_web_view_), javascript_code, std::move(promise));
+		}
+
+		auto WebViewLinux::do_resolve(const call_id_type id, const bytes_view_type bytes) -> void
+		{
+	#if WEBKIT_CHECK_VERSION(2, 40, 0)
+			if (current_javascript_runnable_)
+			{
+				// The bytes are passed as the argument of a function whose body never changes, no script is built for them.
+				constexpr string_view_type body{"window.external.__reply([[id,1,new Uint8Array(bytes)]]);"};
+
+				GVariantDict arguments;
+				g_variant_dict_init(&arguments, nullptr);
+				g_variant_dict_insert_value(&arguments, "id", g_variant_new_uint32(id));
+				g_variant_dict_insert_value(&arguments, "bytes", g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, bytes.data(), bytes.size(), sizeof(std::byte)));
+
+				webkit_web_view_call_async_javascript_function(
+						WEBKIT_WEB_VIEW(gtk_web_view_),
+						body.data(),
+						static_cast<gssize>(body.size()),
+						g_variant_dict_end(&arguments),
+						nullptr,
+						nullptr,
+						nullptr,
+						nullptr,
+						nullptr);
+				return;
+			}
+	#endif
+
+			// A script, after those waiting for the page (the replies settled before it included).
+			string_type code{reply_function_name};
+			code.append("([[");
+			json::append(code, id);
+			code.append(",1,");
+			append_bytes(code, bytes);
+			code.append("]])");
+			do_eval(code, eval_promise_type{});
+		}
+
+		auto WebViewLinux::do_wake_up() const -> void
+		{
+			(void)this;
+			// the loop source is checked again
+			g_main_context_wakeup(nullptr);
+		}
+
+		auto WebViewLinux::do_register_scheme(const string_view_type scheme) const -> void
+		{
+			const string_type name{scheme};
+			auto*             context = webkit_web_view_get_context(WEBKIT_WEB_VIEW(gtk_web_view_));
+
+			// A scheme cannot be unregistered and the context is shared (the default one or the one of the host),
+			// so it is registered once per context and every request is served by the web view which made it.
+			const auto key = string_type{scheme_key_prefix}.append(name);
+			if (g_object_get_data(G_OBJECT(context), key.c_str())) { return; }
+			g_object_set_data(G_OBJECT(context), key.c_str(), GINT_TO_POINTER(1));
+
+			webkit_web_context_register_uri_scheme(
+					context,
+					name.c_str(),
+					+[](WebKitURISchemeRequest* request, [[maybe_unused]] const gpointer arg) -> void
 					{
-						auto* wv = static_cast<WebViewLinux*>(arg);
-						assert(wv && "Invalid web view!");
-						wv->current_javascript_running_ = false;
+						const auto* registry = [request]() -> const AssetRegistry*
+						{
+							auto* webkit_wv = webkit_uri_scheme_request_get_web_view(request);
+							if (!webkit_wv) { return nullptr; }
+
+							// nullptr once the web view is gone
+							const auto* wv = static_cast<const WebViewLinux*>(g_object_get_data(G_OBJECT(webkit_wv), web_view_key));
+							if (!wv) { return nullptr; }
+
+							const auto* scheme = webkit_uri_scheme_request_get_scheme(request);
+							const string_view_type name{scheme ? scheme : ""};
+							// the last registration wins
+							const auto it = std::ranges::find_if(wv->schemes_ | std::views::reverse, [name](const auto& pair) -> bool { return pair.first == name; });
+							return it == std::ranges::end(wv->schemes_ | std::views::reverse) ? nullptr : it->second;
+						}();
+
+						if (!registry)
+						{
+							auto* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "no such scheme");
+							webkit_uri_scheme_request_finish_error(request, error);
+							g_error_free(error);
+							return;
+						}
+
+						respond_uri_scheme_request(request, *registry);
 					},
-					this);
+					nullptr,
+					nullptr);
 
-			while (current_javascript_running_) { g_main_context_iteration(nullptr, TRUE); }
+			// Treat it like https, so that fetch / modules / service workers work
+			auto* security_manager = webkit_web_context_get_security_manager(context);
+			webkit_security_manager_register_uri_scheme_as_secure(security_manager, name.c_str());
+			webkit_security_manager_register_uri_scheme_as_cors_enabled(security_manager, name.c_str());
 		}
 
 		auto WebViewLinux::do_service_start() -> ServiceStartResult
 		{
 			assert(service_state_ == ServiceStateResult::INITIALIZED && "Initialize service first!");
 
-			// Add scrolling container
-			auto* scrolled = gtk_scrolled_window_new(nullptr, nullptr);
-			gtk_container_add(GTK_CONTAINER(gtk_window_), scrolled);
+			// Add scrolling container (nobody scrolls an offscreen window)
+			auto* container = gtk_window_;
+			if (!headless_)
+			{
+				container = gtk_scrolled_window_new(nullptr, nullptr);
+				gtk_container_add(GTK_CONTAINER(gtk_window_), container);
+			}
 
 			// Content manager
-			auto* content_manager = webkit_user_content_manager_new();
+			content_manager_      = webkit_user_content_manager_new();
+			auto* content_manager = content_manager_;
 			webkit_user_content_manager_register_script_message_handler(content_manager, "external");
 			g_signal_connect(
 					content_manager,
@@ -106,34 +751,112 @@ namespace gal::web_view::impl
 						{
 						auto* wv = static_cast<WebViewLinux*>(arg);
 						assert(wv && "Invalid web view!");
-						if (wv->current_callback_)
-						{
 						auto* js_value = webkit_javascript_result_get_js_value(result);
-						wv->current_callback_(*wv, string_type{jsc_value_to_string(js_value)});
+
+						if (jsc_value_is_array(js_value))
+						{
+						const auto message = read_binary_message(js_value, wv->message_resource());
+						wv->receive_message(message.id, message.name.get(), message.bytes);
+						return;
 						}
+
+						// The buffer is released as soon as the message has been dispatched.
+						auto* const bytes = jsc_value_to_string_as_bytes(js_value);
+
+						gsize       size;
+						const auto* data = static_cast<const char*>(g_bytes_get_data(bytes, &size));
+						wv->receive_message({data, size});
+
+						g_bytes_unref(bytes);
 						}),
 					this);
 
 			// web view
-			gtk_web_view_ = webkit_web_view_new_with_user_content_manager(content_manager);
+			// Every web view has its own content manager (the bridge), the rest comes from the host if there is one.
+			if (host_)
+			{
+				gtk_web_view_ = GTK_WIDGET(g_object_new(
+						WEBKIT_TYPE_WEB_VIEW,
+						"user-content-manager",
+						content_manager,
+						"web-context",
+						host_->web_context(),
+						// share the web process of another web view (if any)
+						"related-view",
+						host_->related_view(*this),
+						nullptr));
+			}
+			else { gtk_web_view_ = webkit_web_view_new_with_user_content_manager(content_manager); }
 			g_signal_connect(
 					G_OBJECT(gtk_web_view_),
 					"load-changed",
 					G_CALLBACK(
 						+[](
-							[[maybe_unused]] WebKitWebView* webkit_wv,
+							WebKitWebView* webkit_wv,
 							const WebKitLoadEvent event,
 							const gpointer arg) -> void
 						{
-						if (event == WEBKIT_LOAD_FINISHED)
-						{
 						auto* wv = static_cast<WebViewLinux*>(arg);
 						assert(wv && "Invalid web view!");
+
+						const auto* uri = webkit_web_view_get_uri(webkit_wv);
+						const string_view_type url{uri ? uri : ""};
+
+						switch (event)
+						{
+						case WEBKIT_LOAD_STARTED:
+						{
+						wv->navigation_changed(NavigationEvent::STARTED, url);
+						break;
+						}
+						case WEBKIT_LOAD_REDIRECTED:
+						{
+						wv->navigation_changed(NavigationEvent::REDIRECTED, url);
+						break;
+						}
+						case WEBKIT_LOAD_COMMITTED:
+						{
+						wv->navigation_changed(NavigationEvent::COMMITTED, url);
+						break;
+						}
+						case WEBKIT_LOAD_FINISHED:
+						{
 						wv->current_javascript_runnable_ = true;
+
+						for (auto pending = std::exchange(wv->pending_javascript_, {});
+						     auto& [code, promise]: pending) { run_javascript(WEBKIT_WEB_VIEW(wv->gtk_web_view_), code, std::move(promise)); }
+
+						// after "load-failed" if the load failed (ignored then)
+						wv->navigation_changed(NavigationEvent::FINISHED, url);
+						break;
+						}
 						}
 						}),
 					this);
-			gtk_container_add(GTK_CONTAINER(scrolled), gtk_web_view_);
+			g_signal_connect(
+					G_OBJECT(gtk_web_view_),
+					"load-failed",
+					G_CALLBACK(
+						+[](
+							[[maybe_unused]] WebKitWebView* webkit_wv,
+							[[maybe_unused]] const WebKitLoadEvent event,
+							const gchar* failing_uri,
+							GError* error,
+							const gpointer arg) -> gboolean
+						{
+						auto* wv = static_cast<WebViewLinux*>(arg);
+						assert(wv && "Invalid web view!");
+
+						wv->navigation_changed(NavigationEvent::FAILED, failing_uri ? failing_uri : "", error && error->message ? error->message : "");
+						// let the web view show its error page
+						return FALSE;
+						}),
+					this);
+			gtk_container_add(GTK_CONTAINER(container), gtk_web_view_);
+
+			// custom schemes must be registered before the first request
+			g_object_set_data(G_OBJECT(gtk_web_view_), web_view_key, this);
+			for (const auto& scheme: schemes_ | std::views::keys) { do_register_scheme(scheme); }
 
 			g_signal_connect(
 					G_OBJECT(gtk_window_),
@@ -145,6 +868,10 @@ namespace gal::web_view::impl
 						{
 						auto* wv = static_cast<WebViewLinux*>(arg);
 						assert(wv && "Invalid web view!");
+						// already gone
+						if (wv->gtk_web_view_) { g_object_set_data(G_OBJECT(wv->gtk_web_view_), web_view_key, nullptr); }
+						wv->gtk_window_   = nullptr;
+						wv->gtk_web_view_ = nullptr;
 						wv->shutdown();
 						}),
 					this);
@@ -175,14 +902,10 @@ namespace gal::web_view::impl
 						nullptr);
 			}
 
-			webkit_user_content_manager_add_script(
-					content_manager,
-					webkit_user_script_new(
-							inject_javascript_code_.c_str(),
-							WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
-							WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
-							nullptr,
-							nullptr));
+			// the bridge first, then the scripts / style sheets added so far
+			bridge_script_ = acquire_user_script(inject_javascript_code_, InjectFrames::TOP_FRAME, InjectTime::DOCUMENT_START);
+			webkit_user_content_manager_add_script(content_manager, bridge_script_);
+			for (const auto& injection: injections()) { do_add_injection(injection); }
 
 			// Monitor for fullscreen changes
 			g_signal_connect(
@@ -222,15 +945,18 @@ namespace gal::web_view::impl
 
 			// Done initialization
 			service_state_ = ServiceStateResult::RUNNING;
+			if (host_ && !pooled_) { host_->on_service_start(); }
 
 			set_window_title(window_title_);
 			set_window_fullscreen(window_is_fullscreen_);
 			// navigate to the url
 			navigate(current_url_);
 
-			// show
+			// show (an offscreen window has to be shown too, otherwise nothing is rendered)
 			gtk_widget_grab_focus(gtk_web_view_);
-			gtk_widget_show_all(gtk_window_);
+			if (window_is_visible_ || headless_) { gtk_widget_show_all(gtk_window_); }
+			// everything but the window itself, the page is loaded all the same
+			else { gtk_widget_show_all(gtk_bin_get_child(GTK_BIN(gtk_window_))); }
 
 			return ServiceStartResult::SUCCESS;
 		}
@@ -241,7 +967,67 @@ namespace gal::web_view::impl
 			return service_state_ != ServiceStateResult::SHUTDOWN;
 		}
 
-		auto WebViewLinux::do_shutdown() -> void { service_state_ = ServiceStateResult::SHUTDOWN; }
+		auto WebViewLinux::do_iteration(const std::chrono::milliseconds timeout) const -> bool
+		{
+			// A source which is always ready (an idle callback adding itself again) must not keep us here forever.
+			constexpr int max_dispatches = 256;
+
+			bool  timed_out = false;
+			guint timer     = 0;
+			if (timeout.count() != 0)
+			{
+				// the first event (or the timer) ends the wait
+				timer = g_timeout_add(
+						static_cast<guint>(to_poll_timeout(timeout)),
+						+[](const gpointer arg) -> gboolean
+						{
+							*static_cast<bool*>(arg) = true;
+							return G_SOURCE_REMOVE;
+						},
+						&timed_out);
+				g_main_context_iteration(nullptr, TRUE);
+			}
+
+			for (int i = 0; i < max_dispatches && service_state_ != ServiceStateResult::SHUTDOWN; ++i)
+			{
+				if (g_main_context_iteration(nullptr, FALSE) == FALSE) { break; }
+			}
+
+			if (timer != 0 && !timed_out) { g_source_remove(timer); }
+			return service_state_ != ServiceStateResult::SHUTDOWN;
+		}
+
+		auto WebViewLinux::do_run() -> void
+		{
+			if (service_state_ == ServiceStateResult::SHUTDOWN) { return; }
+
+			const auto was_running_loop = std::exchange(runs_loop_, true);
+			gtk_main();
+			runs_loop_ = was_running_loop;
+		}
+
+		auto WebViewLinux::do_shutdown() -> void
+		{
+			if (service_state_ == ServiceStateResult::SHUTDOWN) { return; }
+			const auto was_running = service_state_ == ServiceStateResult::RUNNING;
+			service_state_         = ServiceStateResult::SHUTDOWN;
+
+			// the loop of the host keeps running until the last web view is shut down
+			if (host_)
+			{
+				if (was_running && !pooled_) { host_->on_shutdown(); }
+			}
+			// leave `run()`, a loop run by someone else is left alone
+			else if (runs_loop_) { gtk_main_quit(); }
+		}
+
+		auto WebViewLinux::set_pooled(const bool pooled) -> void
+		{
+			if (std::exchange(pooled_, pooled) == pooled || !host_ || service_state_ != ServiceStateResult::RUNNING) { return; }
+
+			if (pooled) { host_->on_shutdown(); }
+			else { host_->on_service_start(); }
+		}
 	}
 }
 
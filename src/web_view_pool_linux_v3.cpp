@@ -0,0 +1,99 @@
+#if defined(GAL_WEBVIEW_PLATFORM_LINUX)
+
+#include <webview/impl/v3/web_view_pool_linux_v3.hpp>
+
+#include <gtk-3.0/gtk/gtk.h>
+#include <algorithm>
+#include <cassert>
+
+namespace gal::web_view::impl
+{
+	inline namespace v3
+	{
+		WebViewPool::WebViewPool(const size_type capacity, factory_type&& factory)
+			: capacity_{capacity},
+			  factory_{std::move(factory)},
+			  refill_source_{0}
+		{
+			assert(factory_ && "Invalid factory!");
+
+			web_views_.reserve(capacity_);
+			// nothing is created before the loop runs
+			schedule_refill();
+		}
+
+		WebViewPool::~WebViewPool() noexcept
+		{
+			if (refill_source_ != 0) { g_source_remove(refill_source_); }
+		}
+
+		auto WebViewPool::create() const -> pointer_type
+		{
+			auto web_view = factory_();
+			if (!web_view) { return nullptr; }
+
+			web_view->set_window_visible(false);
+			web_view->set_pooled(true);
+			if (web_view->service_start() != ServiceStartResult::SUCCESS) { return nullptr; }
+			return web_view;
+		}
+
+		auto WebViewPool::schedule_refill() -> void
+		{
+			if (refill_source_ != 0 || web_views_.size() >= capacity_) { return; }
+
+			// after everything else (events, redraws...), so that the pool never delays what the user sees
+			refill_source_ = g_idle_add_full(
+					G_PRIORITY_DEFAULT_IDLE,
+					+[](const gpointer arg) -> gboolean
+					{
+						auto* pool = static_cast<WebViewPool*>(arg);
+						assert(pool && "Invalid pool!");
+
+						if (pool->refill()) { return G_SOURCE_CONTINUE; }
+						pool->refill_source_ = 0;
+						return G_SOURCE_REMOVE;
+					},
+					this,
+					nullptr);
+		}
+
+		auto WebViewPool::refill() -> bool
+		{
+			if (web_views_.size() >= capacity_) { return false; }
+
+			auto web_view = create();
+			// do not try again and again
+			if (!web_view) { return false; }
+
+			web_views_.push_back(std::move(web_view));
+			return web_views_.size() < capacity_;
+		}
+
+		auto WebViewPool::acquire() -> pointer_type
+		{
+			// the oldest one is the most likely to be loaded already
+			const auto it = std::ranges::find_if(web_views_, [](const pointer_type& web_view) -> bool { return web_view->current_javascript_runnable_; });
+
+			pointer_type web_view{};
+			if (it != web_views_.end())
+			{
+				web_view = std::move(*it);
+				web_views_.erase(it);
+			}
+			else if (!web_views_.empty())
+			{
+				web_view = std::move(web_views_.front());
+				web_views_.erase(web_views_.begin());
+			}
+			else { web_view = create(); }
+
+			// from now on it keeps the loop of its host running
+			if (web_view) { web_view->set_pooled(false); }
+			schedule_refill();
+			return web_view;
+		}
+	}
+}
+
+#endif
@@ -9,10 +9,12 @@
 	#include <windows.h>
 	#include <wrl.h>
 
+	#include <algorithm>
 	#include <bit>
 	#include <cassert>
 	#include <filesystem>
 	#include <memory>
+	#include <string_view>
 	#include <webview/impl/v3/web_view_windows_v3.hpp>
 
 namespace
@@ -142,6 +144,40 @@ namespace
 		return USER_DEFAULT_SCREEN_DPI;
 	}
 
+	// WebView2 runs the scripts in every frame at the creation of the document, the rest is done by the script itself.
+	[[nodiscard]] auto to_document_script(const web_view_windows::injection_type& injection) -> web_view_windows::string_type
+	{
+		using gal::web_view::InjectFrames;
+		using gal::web_view::InjectTime;
+
+		web_view_windows::string_type code{};
+		if (injection.frames == InjectFrames::TOP_FRAME) { code.append("if(window===window.top){"); }
+
+		if (injection.style_sheet)
+		{
+			code.append("document.addEventListener('DOMContentLoaded',()=>{const style=document.createElement('style');style.textContent=");
+			gal::web_view::impl::json::append_string(code, injection.code);
+			code.append(";document.head.appendChild(style);});");
+		}
+		else if (injection.time == InjectTime::DOCUMENT_END) { code.append("document.addEventListener('DOMContentLoaded',()=>{").append(injection.code).append("\n});"); }
+		else { code.append(injection.code); }
+
+		if (injection.frames == InjectFrames::TOP_FRAME) { code.append("\n}"); }
+		return code;
+	}
+
+	// ExecuteScript gives the result as JSON, a string is given as it is (like WebKitGTK does), any other value as its JSON.
+	[[nodiscard]] auto to_eval_result(web_view_windows::string_type&& json) -> web_view_windows::string_type
+	{
+		std::string_view input{json};
+		if (web_view_windows::string_type string{};
+			gal::web_view::impl::json::read_string(input, string) && input.empty())
+		{
+			return string;
+		}
+		return std::move(json);
+	}
+
 	auto CALLBACK WndProcedure(
 			const_hwnd	 window,
 			const UINT	 msg,
@@ -210,8 +246,6 @@ namespace gal::web_view::impl
 			  window_info_{},
 			  window_{nullptr}
 		{
-			inject_javascript_code_ = "window.external." GAL_WEBVIEW_METHOD_NAME "=arg=>window.chrome.webview.postMessage(arg);";
-
 			HMODULE handle;
 			if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, nullptr, &handle) == 0 || !handle)
 			{
@@ -292,16 +326,129 @@ namespace gal::web_view::impl
 			service_state_ = ServiceStateResult::INITIALIZED;
 		}
 
-	#ifndef GAL_WEBVIEW_PUBLIC_WEBVIEW2
 		WebViewWindows::~WebViewWindows() noexcept
 		{
+			stop_workers();
+			end_lifetime();
+
+	#ifndef GAL_WEBVIEW_PUBLIC_WEBVIEW2
 			web_view_controller_->Release();
 			web_view_window_->Release();
 
 			web_view_controller_ = nullptr;
 			web_view_window_	 = nullptr;
-		}
 	#endif
+		}
+
+		auto WebViewWindows::add_document_script(const injection_id_type id, const string_view_type javascript_code) -> void
+		{
+			script_ids_.emplace_back(id, std::wstring{});
+
+			web_view_window_->AddScriptToExecuteOnDocumentCreated(
+					to_wchar_string(javascript_code).data(),
+					Microsoft::WRL::Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
+							[this, id](const HRESULT error_code, const LPCWSTR script_id) -> HRESULT
+							{
+								if (FAILED(error_code)) { return S_OK; }
+
+								// removed in the meantime
+								if (const auto it = std::ranges::find(script_ids_, id, &decltype(script_ids_)::value_type::first);
+									it == script_ids_.end()) { web_view_window_->RemoveScriptToExecuteOnDocumentCreated(script_id); }
+								else { it->second = script_id; }
+								return S_OK;
+							})
+							.Get());
+		}
+
+		auto WebViewWindows::remove_document_script(const injection_id_type id) -> void
+		{
+			const auto it = std::ranges::find(script_ids_, id, &decltype(script_ids_)::value_type::first);
+			if (it == script_ids_.end()) { return; }
+
+			// otherwise it is removed as soon as its id is known
+			if (!it->second.empty()) { web_view_window_->RemoveScriptToExecuteOnDocumentCreated(it->second.c_str()); }
+			script_ids_.erase(it);
+		}
+
+		auto WebViewWindows::post_inject(const string_view_type inject_javascript_code) -> void
+		{
+			// the bridge is added when the service starts
+			if (service_state_ != ServiceStateResult::RUNNING) { return; }
+
+			remove_document_script(invalid_injection_id);
+			add_document_script(invalid_injection_id, inject_javascript_code);
+		}
+
+		auto WebViewWindows::do_add_injection(const injection_type& injection) -> void { add_document_script(injection.id, to_document_script(injection)); }
+
+		auto WebViewWindows::do_remove_injection(const injection_type& injection) -> void { remove_document_script(injection.id); }
+
+		auto WebViewWindows::add_navigation_handlers() -> void
+		{
+			// the url of the document at that time
+			const auto source = [](ICoreWebView2* sender) -> string_type
+			{
+				LPWSTR uri = nullptr;
+				if (FAILED(sender->get_Source(&uri)) || !uri) { return {}; }
+
+				string_type url{from_wchar_string(uri)};
+				CoTaskMemFree(uri);
+				return url;
+			};
+
+			web_view_window_->add_NavigationStarting(
+					Microsoft::WRL::Callback<ICoreWebView2NavigationStartingEventHandler>(
+							[this](
+									[[maybe_unused]] ICoreWebView2*		 sender,
+									ICoreWebView2NavigationStartingEventArgs* args) -> HRESULT
+							{
+								LPWSTR uri = nullptr;
+								BOOL   is_redirected = FALSE;
+								args->get_Uri(&uri);
+								args->get_IsRedirected(&is_redirected);
+
+								const string_type url{uri ? from_wchar_string(uri) : string_type{}};
+								if (uri) { CoTaskMemFree(uri); }
+
+								navigation_changed(is_redirected ? NavigationEvent::REDIRECTED : NavigationEvent::STARTED, url);
+								return S_OK;
+							})
+							.Get(),
+					nullptr);
+
+			web_view_window_->add_ContentLoading(
+					Microsoft::WRL::Callback<ICoreWebView2ContentLoadingEventHandler>(
+							[this, source](
+									ICoreWebView2*								  sender,
+									[[maybe_unused]] ICoreWebView2ContentLoadingEventArgs* args) -> HRESULT
+							{
+								navigation_changed(NavigationEvent::COMMITTED, source(sender));
+								return S_OK;
+							})
+							.Get(),
+					nullptr);
+
+			web_view_window_->add_NavigationCompleted(
+					Microsoft::WRL::Callback<ICoreWebView2NavigationCompletedEventHandler>(
+							[this, source](
+									ICoreWebView2*						 sender,
+									ICoreWebView2NavigationCompletedEventArgs* args) -> HRESULT
+							{
+								BOOL is_success = FALSE;
+								args->get_IsSuccess(&is_success);
+
+								if (is_success) { navigation_changed(NavigationEvent::FINISHED, source(sender)); }
+								else
+								{
+									COREWEBVIEW2_WEB_ERROR_STATUS status = COREWEBVIEW2_WEB_ERROR_STATUS_UNKNOWN;
+									args->get_WebErrorStatus(&status);
+									navigation_changed(NavigationEvent::FAILED, source(sender), "web error status " + std::to_string(static_cast<int>(status)));
+								}
+								return S_OK;
+							})
+							.Get(),
+					nullptr);
+		}
 
 		auto WebViewWindows::do_set_window_title(const string_view_type title) const -> void
 		{
@@ -374,21 +521,38 @@ namespace gal::web_view::impl
 			return NavigateResult::SUCCESS;
 		}
 
-		auto WebViewWindows::do_eval(const string_view_type javascript_code) const -> void
+		auto WebViewWindows::do_eval(const string_view_type javascript_code, eval_promise_type&& promise) const -> void
 		{
-			// Schedule an async task to get the document URL
+			// Schedule an async task, the completion handler is invoked on the UI thread
 			web_view_window_->ExecuteScript(
 					to_wchar_string(javascript_code).data(),
 					Microsoft::WRL::Callback<ICoreWebView2ExecuteScriptCompletedHandler>(
-							[](const HRESULT error_code, const LPCWSTR result_object_as_json) -> HRESULT
+							[promise = std::move(promise)](const HRESULT error_code, const LPCWSTR result_object_as_json) mutable -> HRESULT
 							{
-								// todo
-								if (FAILED(error_code)) { (void)result_object_as_json; }
+								if (FAILED(error_code)) { promise.set_value({EvalResult::EVAL_FAILED, {}}); }
+								else { promise.set_value({EvalResult::SUCCESS, to_eval_result(string_type{from_wchar_string(result_object_as_json)})}); }
 								return S_OK;
 							})
 							.Get());
 		}
 
+		auto WebViewWindows::do_wake_up_after(const std::chrono::milliseconds delay) const -> void
+		{
+			(void)this;
+			// A thread timer, GetMessage returns once it expires (and it is killed as soon as it is dispatched)
+			SetTimer(
+					nullptr,
+					0,
+					static_cast<UINT>(delay.count()),
+					+[]([[maybe_unused]] HWND hwnd, [[maybe_unused]] UINT message, const UINT_PTR id, [[maybe_unused]] DWORD time) -> void { KillTimer(nullptr, id); });
+		}
+
+		auto WebViewWindows::do_wake_up() const -> void
+		{
+			// GetMessage returns
+			PostMessage(window_, WM_NULL, 0, 0);
+		}
+
 		auto WebViewWindows::do_service_start() -> ServiceStartResult
 		{
 			assert(service_state_ == ServiceStateResult::INITIALIZED && "Initialize service first!");
@@ -407,21 +571,19 @@ namespace gal::web_view::impl
 							[[maybe_unused]] ICoreWebView2*			  web_view,
 							ICoreWebView2WebMessageReceivedEventArgs* args) -> HRESULT
 			{
-				if (current_callback_)
+				LPWSTR message;
+				// args->get_WebMessageAsJson(&message);
+				if (const auto result = args->TryGetWebMessageAsString(&message);
+					FAILED(result))
 				{
-					LPWSTR message;
-					// args->get_WebMessageAsJson(&message);
-					if (const auto result = args->TryGetWebMessageAsString(&message);
-						FAILED(result))
-					{
-						// todo
-						return result;
-					}
+					// todo
+					return result;
+				}
 
-					current_callback_(*this, from_wchar_string(message));
+				const string_type string{from_wchar_string(message)};
+				CoTaskMemFree(message);
 
-					CoTaskMemFree(message);
-				}
+				receive_message(string);
 				return S_OK;
 			};
 
@@ -458,21 +620,16 @@ namespace gal::web_view::impl
 				// Resize WebView
 				resize();
 
-				web_view_window_->AddScriptToExecuteOnDocumentCreated(
-						to_wchar_string(inject_javascript_code_).data(),
-						Microsoft::WRL::Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
-								[](const HRESULT created_error_code, const LPCWSTR id) -> HRESULT
-								{
-									// todo
-									if (FAILED(created_error_code)) { (void)id; }
-									return S_OK;
-								})
-								.Get());
+				// the bridge first, then the scripts / style sheets added so far
+				add_document_script(invalid_injection_id, inject_javascript_code_);
+				for (const auto& injection: injections()) { do_add_injection(injection); }
 
 				web_view_window_->add_WebMessageReceived(
 						Microsoft::WRL::Callback<ICoreWebView2WebMessageReceivedEventHandler>(on_web_message_received).Get(),
 						nullptr);
 
+				add_navigation_handlers();
+
 				// Done initialization, set properties
 				service_state_ = ServiceStateResult::RUNNING;
 
@@ -562,6 +719,33 @@ namespace gal::web_view::impl
 			return is_running;
 		}
 
+		auto WebViewWindows::do_iteration(const std::chrono::milliseconds timeout) const -> bool
+		{
+			(void)this;
+			// A window which keeps posting messages to itself must not keep us here forever.
+			constexpr int max_dispatches = 256;
+
+			// returns as soon as a message arrives (or the timeout expires)
+			if (timeout.count() != 0)
+			{
+				MsgWaitForMultipleObjectsEx(
+						0,
+						nullptr,
+						timeout == std::chrono::milliseconds::max() ? INFINITE : static_cast<DWORD>(timeout.count()),
+						QS_ALLINPUT,
+						MWMO_INPUTAVAILABLE);
+			}
+
+			MSG msg;
+			for (int i = 0; i < max_dispatches && PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE); ++i)
+			{
+				if (msg.message == WM_QUIT) { return false; }
+				TranslateMessage(&msg);
+				DispatchMessage(&msg);
+			}
+			return true;
+		}
+
 		auto WebViewWindows::do_shutdown() const -> void
 		{
 			(void)this;
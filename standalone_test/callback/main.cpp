@@ -1,6 +1,7 @@
 #include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
 #include <webview/webview.hpp>
 
 template<typename FunctionType>
@@ -43,6 +44,7 @@ auto build_html() -> bool
 
 		<input type="text" id="input" />
 		<button id="btn">Calculate</button>
+		<button id="shutdown">Shutdown</button>
 		<div id="ans"></div>
 
 		<script type="text/javascript">
@@ -59,6 +61,7 @@ auto build_html() -> bool
 			"const input = document.getElementById('input');\n"
 			"   const btn = document.getElementById('btn');\n"
 			"   const ans = document.getElementById('ans');\n"
+			"   document.getElementById('shutdown').onclick = () => window.external." JS_SHUTDOWN_METHOD_NAME "();\n"
 			"\n"
 			"   input.onkeydown = function(e) {\n"
 			"       if (e.key === 'Enter') {\n"
@@ -79,7 +82,7 @@ auto build_html() -> bool
 			"       // Linux\n"
 			"       // window.webkit.messageHandlers.external.postMessage(input.value);\n"
 			"       window.external." GAL_WEBVIEW_METHOD_NAME
-			"(input.value);\n"
+			"(input.value).then(" JS_RECEIVE_RESULT_METHOD_NAME ", " JS_RECEIVE_RESULT_METHOD_NAME ");\n"
 			"   }\n"
 			"\n"
 			"   function " JS_RECEIVE_RESULT_METHOD_NAME
@@ -138,8 +141,10 @@ auto main(
 	target_url.append(CALLBACK_TEST_HTML_PATH);
 	web_view.navigate(target_url);
 
-	web_view.register_javascript_callback(
-			[](gal::web_view::WebView& wv, gal::web_view::WebView::string_type&& arg) -> void
+	// computed by a worker thread, the window keeps responding meanwhile
+	web_view.bind(
+			GAL_WEBVIEW_METHOD_NAME,
+			[](const gal::web_view::WebView::string_view_type arg) -> std::size_t
 			{
 				constexpr auto  factorial = y_combinator{
 						[](auto self, std::size_t n) -> std::size_t
@@ -148,28 +153,23 @@ auto main(
 							return n * self(n - 1);
 						}};
 
-				if (arg == JS_SHUTDOWN_METHOD_NAME)
-				{
-					wv.shutdown();
-					return;
-				}
-
 				std::size_t num;
 				if (const auto [ptr, ec] = std::from_chars(
-							arg.c_str(),
-							arg.c_str() + arg.size(),
+							arg.data(),
+							arg.data() + arg.size(),
 							num);
-					ec != std::errc{} || ptr != arg.c_str() + arg.size())
+					ec != std::errc{} || ptr != arg.data() + arg.size())
 				{
-					const gal::web_view::WebView::string_type js{JS_RECEIVE_RESULT_METHOD_NAME "(\"cannot eval '" + arg + "' for factorial!\")"};
-					wv.eval(js);
+					throw std::invalid_argument{gal::web_view::WebView::string_type{"cannot eval '"}.append(arg).append("' for factorial!")};
 				}
-				else
-				{
-					const gal::web_view::WebView::string_type js{JS_RECEIVE_RESULT_METHOD_NAME "(" + std::to_string(factorial(num)) + ")"};
-					wv.eval(js);
-				}
-			});
+
+				return factorial(num);
+			},
+			gal::web_view::Execution::POOL);
+
+	web_view.bind(
+			JS_SHUTDOWN_METHOD_NAME,
+			[](gal::web_view::WebView& wv, [[maybe_unused]] const gal::web_view::WebView::string_view_type arg) -> void { wv.shutdown(); });
 
 	if (web_view.service_start() != gal::web_view::ServiceStartResult::SUCCESS) { return -2; }
 
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <webview/impl/v3/process_memory_linux_v3.hpp>
+#include <webview/webview.hpp>
+
+// Pre-render a page without showing anything on the screen (run it under Xvfb on a machine without a display):
+//	webview-standalone-test-headless [url] > page.html
+// The rendered html is written to stdout, the startup time and the memory usage are reported to stderr.
+
+auto main(
+		const int argc,
+		char*     argv[]) -> int
+{
+	using clock_type = std::chrono::steady_clock;
+
+	const auto start_time = clock_type::now();
+
+	gal::web_view::WebView web_view{
+			/*.window_width = */ 1280,
+			/*.window_height = */ 720,
+			/*.window_title = */ "headless web view",
+			/*.window_is_fixed = */ false,
+			/*.window_is_fullscreen = */ false,
+			/*.web_view_use_dev_tools = */ false,
+			/*.index_url = */ gal::web_view::WebView::string_type{argc > 1 ? argv[1] : gal::web_view::WebView::default_index_url},
+			/*.headless = */ true,
+	};
+
+	if (web_view.service_start() != gal::web_view::ServiceStartResult::SUCCESS) { return -1; }
+	const auto started_time = clock_type::now();
+
+	// The script is deferred until the page has been loaded
+	const auto [result, html] = web_view.eval("document.documentElement.outerHTML");
+	if (result != gal::web_view::EvalResult::SUCCESS) { return -2; }
+	const auto loaded_time = clock_type::now();
+
+	std::fwrite(html.data(), 1, html.size(), stdout);
+
+	const auto to_ms = [](const clock_type::duration duration) -> double { return std::chrono::duration<double, std::milli>{duration}.count(); };
+	std::fprintf(
+			stderr,
+			"service_start: %.2f ms\n"
+			"first load: %.2f ms\n"
+			"rss (ui process): %zu KiB\n"
+			"rss (web processes): %zu KiB\n",
+			to_ms(started_time - start_time),
+			to_ms(loaded_time - start_time),
+			gal::web_view::impl::process_memory::resident_set_size(),
+			gal::web_view::impl::process_memory::descendants_resident_set_size());
+
+	web_view.shutdown();
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <webview/webview.hpp>
+
+// The loop run by a web view keeps running while the web views of a pool are handed out, shut down and destroyed (and the pool with them):
+//	webview-standalone-test-pool
+// Run it under Xvfb on a machine without a display, it is skipped (77) if GTK cannot be initialized.
+
+namespace
+{
+	constexpr int skipped = 77;
+
+	[[nodiscard]] auto make_web_view() -> std::unique_ptr<gal::web_view::WebView>
+	{
+		return std::make_unique<gal::web_view::WebView>(
+				/*.window_width = */ 640,
+				/*.window_height = */ 480,
+				/*.window_title = */ "pooled web view",
+				/*.window_is_fixed = */ false,
+				/*.window_is_fullscreen = */ false,
+				/*.web_view_use_dev_tools = */ false,
+				/*.index_url = */ gal::web_view::WebView::string_type{gal::web_view::WebView::default_index_url},
+				/*.headless = */ true);
+	}
+}// namespace
+
+auto main() -> int
+{
+	using clock_type = std::chrono::steady_clock;
+
+	gal::web_view::WebView web_view{
+			/*.window_width = */ 640,
+			/*.window_height = */ 480,
+			/*.window_title = */ "loop owner",
+			/*.window_is_fixed = */ false,
+			/*.window_is_fullscreen = */ false,
+			/*.web_view_use_dev_tools = */ false,
+			/*.index_url = */ gal::web_view::WebView::string_type{gal::web_view::WebView::default_index_url},
+			/*.headless = */ true,
+	};
+	if (web_view.service_start() != gal::web_view::ServiceStartResult::SUCCESS) { return skipped; }
+
+	auto pool = std::make_unique<gal::web_view::WebViewPool>(2, make_web_view);
+
+	// only touched on the loop thread
+	int  stage         = 0;
+	bool loop_survived = false;
+
+	const auto deadline = clock_type::now() + std::chrono::seconds{30};
+	const auto step     = [&](gal::web_view::WebView& wv) -> void
+	{
+		if (stage == 0 && pool->size() == pool->capacity())
+		{
+			// a started web view of the pool, destroyed right away
+			auto destroyed = pool->acquire();
+			destroyed.reset();
+
+			// a web view which is shut down (its window is closed) and then destroyed
+			auto closed = pool->acquire();
+			if (closed) { closed->shutdown(); }
+			closed.reset();
+
+			// with the web views it still holds (or is about to create)
+			pool.reset();
+			stage = 1;
+		}
+		// we would not be here if any of them had left the loop
+		else if (stage == 1)
+		{
+			loop_survived = true;
+			stage         = 2;
+			wv.shutdown();
+		}
+		else if (stage == 0 && clock_type::now() > deadline)
+		{
+			std::fputs("the pool was never filled\n", stderr);
+			stage = 2;
+			wv.shutdown();
+		}
+	};
+
+	std::atomic<bool> done{false};
+	std::jthread      driver{
+			[&]() -> void
+			{
+				while (!done.load(std::memory_order_acquire))
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds{50});
+					web_view.dispatch(step);
+				}
+			}};
+
+	web_view.run();
+	done.store(true, std::memory_order_release);
+	driver.join();
+
+	if (!loop_survived)
+	{
+		std::fputs("the loop stopped before the web view which runs it was shut down\n", stderr);
+		return 1;
+	}
+	return 0;
+}
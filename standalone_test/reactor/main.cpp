@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <vector>
+#include <webview/webview.hpp>
+
+// The web view is one participant of an epoll reactor (no extra thread, no `iteration()` / `run()`),
+// the other one is a timer which updates the page every second.
+//	webview-standalone-test-reactor
+
+namespace
+{
+	using gal::web_view::WebView;
+
+	// The fds of the GLib context change from time to time, the interest list follows them.
+	class GLibInterest
+	{
+	public:
+		// epoll_event::data.u64 of the timer
+		constexpr static std::uint64_t timer_tag = 0;
+		constexpr static std::uint64_t glib_tag  = std::uint64_t{1} << 32;
+
+	private:
+		int              epoll_;
+		std::vector<int> registered_;
+
+	public:
+		explicit GLibInterest(const int epoll)
+			: epoll_{epoll} {}
+
+		auto update(const std::span<const WebView::poll_fd_type> fds) -> void
+		{
+			for (const auto fd: registered_)
+			{
+				if (std::ranges::none_of(fds, [fd](const auto& poll_fd) { return poll_fd.fd == fd; })) { epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr); }
+			}
+
+			std::vector<int> registered{};
+			for (const auto& [fd, events, revents]: fds)
+			{
+				epoll_event event{.events = events, .data = {.u64 = glib_tag | static_cast<std::uint32_t>(fd)}};
+				const auto  operation = std::ranges::find(registered_, fd) == registered_.end() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+				epoll_ctl(epoll_, operation, fd, &event);
+				registered.push_back(fd);
+			}
+			registered_ = std::move(registered);
+		}
+	};
+}// namespace
+
+auto main() -> int
+{
+	WebView web_view{
+			/*.window_width = */ 800,
+			/*.window_height = */ 600,
+			/*.window_title = */ "reactor",
+			/*.window_is_fixed = */ false,
+			/*.window_is_fullscreen = */ false,
+			/*.web_view_use_dev_tools = */ false,
+			/*.index_url = */ WebView::string_type{"data:text/html,<h1 id=ticks>0</h1>"}};
+
+	if (web_view.service_start() != gal::web_view::ServiceStartResult::SUCCESS) { return -1; }
+
+	const auto epoll = epoll_create1(EPOLL_CLOEXEC);
+	const auto timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+	constexpr itimerspec every_second{.it_interval = {.tv_sec = 1, .tv_nsec = 0}, .it_value = {.tv_sec = 1, .tv_nsec = 0}};
+	timerfd_settime(timer, 0, &every_second, nullptr);
+
+	epoll_event timer_event{.events = EPOLLIN, .data = {.u64 = GLibInterest::timer_tag}};
+	epoll_ctl(epoll, EPOLL_CTL_ADD, timer, &timer_event);
+
+	GLibInterest interest{epoll};
+	std::uint64_t ticks = 0;
+
+	bool running = true;
+	while (running)
+	{
+		const auto [fds, timeout] = web_view.prepare_poll();
+		interest.update(fds);
+
+		epoll_event events[16];
+		const auto  count = epoll_wait(epoll, events, 16, timeout);
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (events[i].data.u64 != GLibInterest::timer_tag) { continue; }
+
+			std::uint64_t expirations = 0;
+			if (read(timer, &expirations, sizeof(expirations)) == sizeof(expirations)) { ticks += expirations; }
+			web_view.eval_async("document.getElementById('ticks').textContent='" + std::to_string(ticks) + "'");
+		}
+
+		// the web view dispatches whatever is ready, even if only the timer woke us up (nothing to do then)
+		running = web_view.dispatch_ready();
+	}
+
+	close(timer);
+	close(epoll);
+	return 0;
+}
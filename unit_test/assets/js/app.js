@@ -0,0 +1 @@
+window.answer = 42;
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include <boost/ut.hpp>
+#include <unit_test_assets.hpp>
+#include <webview/impl/v3/asset.hpp>
+#include <algorithm>
+
+using namespace boost::ut;
+
+namespace
+{
+	using gal::web_view::impl::AssetRegistry;
+	using gal::web_view::impl::mime_type_of;
+
+	using response_type = AssetRegistry::response_type;
+
+	[[nodiscard]] auto get(const AssetRegistry& registry, const std::string_view path, const std::string_view range = {}, const std::string_view if_none_match = {}) -> response_type
+	{
+		return registry.respond({.method = "GET", .path = path, .range = range, .if_none_match = if_none_match});
+	}
+
+	suite test_asset_registry = []
+	{
+		"mime type"_test = []
+		{
+			expect(mime_type_of("/index.html") == "text/html; charset=utf-8");
+			expect(mime_type_of("/logo.PNG") == "image/png");
+			expect(mime_type_of("/app.wasm") == "application/wasm");
+			expect(mime_type_of("/LICENSE") == "application/octet-stream");
+			expect(mime_type_of("/archive.tar.gz") == "application/octet-stream");
+		};
+
+		"get"_test = []
+		{
+			AssetRegistry registry{};
+			registry.add("/index.html", std::string_view{"0123456789"});
+
+			for (const std::string_view path: {std::string_view{"/index.html"}, std::string_view{"/"}, std::string_view{}})
+			{
+				const auto response = get(registry, path);
+				expect(response.status == 200_i) << path;
+				expect(response.asset && response.asset->mime_type == "text/html; charset=utf-8") << path;
+				expect(response.offset == 0_ull && response.length == 10_ull && response.with_body) << path;
+			}
+
+			const auto missing = get(registry, "/missing.js");
+			expect(missing.status == 404_i);
+			expect(missing.asset == nullptr);
+
+			// no method is a GET
+			expect(registry.respond({.method = {}, .path = "/index.html", .range = {}, .if_none_match = {}}).status == 200_i);
+		};
+
+		"method not allowed"_test = []
+		{
+			AssetRegistry registry{};
+			registry.add("/index.html", std::string_view{"0123456789"});
+
+			for (const std::string_view method: {std::string_view{"POST"}, std::string_view{"PUT"}, std::string_view{"DELETE"}, std::string_view{"get"}})
+			{
+				const auto response = registry.respond({.method = method, .path = "/index.html", .range = {}, .if_none_match = {}});
+				expect(response.status == 405_i) << method;
+				expect(response.asset == nullptr && !response.with_body) << method;
+			}
+		};
+
+		"head"_test = []
+		{
+			AssetRegistry registry{};
+			registry.add("/index.html", std::string_view{"0123456789"});
+
+			const auto response = registry.respond({.method = "HEAD", .path = "/index.html", .range = {}, .if_none_match = {}});
+			expect(response.status == 200_i);
+			expect(response.length == 10_ull) << "the length of what a GET would send";
+			expect(!response.with_body);
+
+			const auto range = registry.respond({.method = "HEAD", .path = "/index.html", .range = "bytes=2-5", .if_none_match = {}});
+			expect(range.status == 206_i);
+			expect(range.offset == 2_ull && range.length == 4_ull);
+			expect(!range.with_body);
+		};
+
+		"etag"_test = []
+		{
+			AssetRegistry registry{};
+			registry.add("/a.js", std::string_view{"let a = 1;"});
+			registry.add("/b.js", std::string_view{"let a = 1;"});
+			registry.add("/c.js", std::string_view{"let c = 1;"});
+
+			const auto& etag = registry.find("/a.js")->etag;
+			expect(etag.size() > 2 && etag.front() == '"' && etag.back() == '"') << etag;
+			expect(registry.find("/b.js")->etag == etag) << "the same bytes";
+			expect(registry.find("/c.js")->etag != etag);
+
+			const auto not_modified = get(registry, "/a.js", {}, etag);
+			expect(not_modified.status == 304_i);
+			expect(not_modified.asset != nullptr);
+			expect(!not_modified.with_body);
+
+			// a list of them
+			expect(get(registry, "/a.js", {}, std::string{"W/\"0\", "} + etag).status == 304_i);
+			// a range is not sent if the cached one is still good
+			expect(get(registry, "/a.js", "bytes=0-1", etag).status == 304_i);
+
+			const auto modified = get(registry, "/c.js", {}, etag);
+			expect(modified.status == 200_i);
+			expect(modified.with_body);
+		};
+
+		"range"_test = []
+		{
+			AssetRegistry registry{};
+			registry.add("/data.bin", std::string_view{"0123456789"});
+
+			struct expected_type
+			{
+				std::string_view         range;
+				AssetRegistry::size_type offset;
+				AssetRegistry::size_type length;
+			};
+
+			for (const auto& [range, offset, length]: {
+					     // bytes=a-b
+					     expected_type{"bytes=2-5", 2, 4},
+					     expected_type{"bytes=0-0", 0, 1},
+					     expected_type{"bytes=0-9", 0, 10},
+					     // clamped to the end
+					     expected_type{"bytes=5-100", 5, 5},
+					     // bytes=a-
+					     expected_type{"bytes=7-", 7, 3},
+					     expected_type{"bytes=0-", 0, 10},
+					     // bytes=-n
+					     expected_type{"bytes=-3", 7, 3},
+					     expected_type{"bytes=-10", 0, 10},
+					     expected_type{"bytes=-20", 0, 10},
+			     })
+			{
+				const auto response = get(registry, "/data.bin", range);
+				expect(response.status == 206_i) << range;
+				expect(response.offset == offset) << range;
+				expect(response.length == length) << range;
+				expect(response.with_body) << range;
+			}
+		};
+
+		"range not satisfiable"_test = []
+		{
+			AssetRegistry registry{};
+			registry.add("/data.bin", std::string_view{"0123456789"});
+
+			for (const std::string_view range: {
+					     // out of range
+					     std::string_view{"bytes=10-"},
+					     std::string_view{"bytes=10-12"},
+					     std::string_view{"bytes=-0"},
+					     // malformed
+					     std::string_view{"bytes=5-2"},
+					     std::string_view{"bytes=a-b"},
+					     std::string_view{"bytes=5"},
+					     std::string_view{"bytes=-"},
+					     std::string_view{"items=0-1"},
+					     // several ranges are not supported
+					     std::string_view{"bytes=0-1,3-4"},
+			     })
+			{
+				const auto response = get(registry, "/data.bin", range);
+				expect(response.status == 416_i) << range;
+				expect(response.asset != nullptr) << range << "the size is reported";
+				expect(!response.with_body) << range;
+			}
+
+			AssetRegistry empty{};
+			empty.add("/empty.txt", std::string_view{});
+			expect(get(empty, "/empty.txt", "bytes=0-").status == 416_i);
+			expect(get(empty, "/empty.txt").status == 200_i);
+		};
+	};
+
+	// unit_test/assets, embedded by gal_webview_embed_assets
+	suite test_embedded_assets = []
+	{
+		constexpr std::string_view index_html{"<!doctype html><title>unit test</title>"};
+
+		"index"_test = []
+		{
+			const auto index = gal::web_view::embedded::unit_test_assets();
+			expect(index.size() == 2_ul);
+			expect(std::ranges::is_sorted(index, {}, &gal::web_view::impl::EmbeddedAsset::path));
+
+			const auto& html = *index.begin();
+			expect(html.path == "/index.html");
+			expect(html.mime_type == "text/html; charset=utf-8");
+			expect(html.encoding.empty());
+			expect(std::string_view{reinterpret_cast<const char*>(html.data), html.size} == index_html);
+		};
+
+		"served"_test = [&]
+		{
+			const auto    index = gal::web_view::embedded::unit_test_assets();
+			AssetRegistry registry{};
+			registry.add(index);
+
+			const auto html = get(registry, "/");
+			expect(html.status == 200_i);
+			expect(html.asset && html.asset->mime_type == "text/html; charset=utf-8");
+			expect(html.asset && html.asset->bytes.data() == index.begin()->bytes().data()) << "served from the static data";
+			expect(html.length == index_html.size());
+
+			const auto script = get(registry, "/js/app.js");
+			expect(script.status == 200_i);
+			expect(script.asset && script.asset->mime_type == "text/javascript; charset=utf-8");
+			expect(script.asset && std::ranges::equal(script.asset->bytes, std::as_bytes(std::span{std::string_view{"window.answer = 42;"}})));
+
+			expect(get(registry, "/js/app.js", {}, registry.find("/js/app.js")->etag).status == 304_i);
+			const auto range = get(registry, "/js/app.js", "bytes=7-12");
+			expect(range.status == 206_i && range.offset == 7_ull && range.length == 6_ull);
+			expect(get(registry, "/js/missing.js").status == 404_i);
+		};
+	};
+}// namespace
@@ -0,0 +1,88 @@
+#include <boost/ut.hpp>
+#include <webview/impl/v3/inplace_function.hpp>
+#include <memory>
+#include <string>
+
+using namespace boost::ut;
+
+namespace
+{
+	using gal::web_view::impl::InplaceFunction;
+
+	// counts the living copies of itself
+	struct Counted
+	{
+		int* alive;
+
+		explicit Counted(int* a) noexcept
+			: alive{a} { ++*alive; }
+
+		Counted(const Counted& other) noexcept
+			: alive{other.alive} { ++*alive; }
+
+		Counted(Counted&& other) noexcept
+			: alive{other.alive} { ++*alive; }
+
+		auto operator=(const Counted&) -> Counted& = delete;
+		auto operator=(Counted&&) -> Counted&      = delete;
+
+		~Counted() noexcept { --*alive; }
+
+		auto operator()(const int value) const noexcept -> int { return value * 2; }
+	};
+
+	static_assert(!std::is_copy_constructible_v<InplaceFunction<auto()->void>>);
+	static_assert(std::is_nothrow_move_constructible_v<InplaceFunction<auto()->void>>);
+	static_assert(!std::is_constructible_v<InplaceFunction<auto()->void>, int>);
+	// the result type does not match
+	static_assert(!std::is_constructible_v<InplaceFunction<auto(int)->std::string>, Counted>);
+
+	suite test_inplace_function = []
+	{
+		"invoke"_test = []
+		{
+			InplaceFunction<auto(int, int)->int> add{[](const int a, const int b) { return a + b; }};
+			expect(static_cast<bool>(add));
+			expect(add(1, 2) == 3_i);
+
+			InplaceFunction<auto(int)->void> empty{};
+			expect(!empty);
+			expect(!InplaceFunction<auto()->void>{nullptr});
+		};
+
+		"mutable state and move only captures"_test = []
+		{
+			InplaceFunction<auto()->int> counter{[count = 0]() mutable { return ++count; }};
+			expect(counter() == 1_i);
+			expect(counter() == 2_i);
+
+			InplaceFunction<auto()->int, 32> owner{[value = std::make_unique<int>(42)] { return *value; }};
+			expect(owner() == 42_i);
+		};
+
+		"move and destroy"_test = []
+		{
+			int alive = 0;
+			{
+				InplaceFunction<auto(int)->int> first{Counted{&alive}};
+				expect(alive == 1_i);
+
+				auto second = std::move(first);
+				expect(alive == 1_i) << "the moved from callable is destroyed";
+				expect(!first);// NOLINT(bugprone-use-after-move)
+				expect(second(21) == 42_i);
+
+				InplaceFunction<auto(int)->int> third{Counted{&alive}};
+				expect(alive == 2_i);
+				third = std::move(second);
+				expect(alive == 1_i);
+				expect(third(1) == 2_i);
+
+				third = nullptr;
+				expect(alive == 0_i);
+				expect(!third);
+			}
+			expect(alive == 0_i);
+		};
+	};
+}// namespace
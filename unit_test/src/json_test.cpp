@@ -0,0 +1,107 @@
+#include <boost/ut.hpp>
+#include <webview/impl/v3/json.hpp>
+#include <random>
+
+using namespace boost::ut;
+
+namespace
+{
+	namespace json = gal::web_view::impl::json;
+
+	// The straightforward version, byte by byte.
+	[[nodiscard]] auto reference_escape(const std::string_view string) -> std::string
+	{
+		constexpr char hex[]{"0123456789abcdef"};
+
+		std::string out{"\""};
+		for (std::size_t i = 0; i < string.size(); ++i)
+		{
+			const auto c = static_cast<unsigned char>(string[i]);
+			if (c == 0xe2 && i + 2 < string.size() && static_cast<unsigned char>(string[i + 1]) == 0x80 && (static_cast<unsigned char>(string[i + 2]) == 0xa8 || static_cast<unsigned char>(string[i + 2]) == 0xa9))
+			{
+				out.append(static_cast<unsigned char>(string[i + 2]) == 0xa8 ? "\\u2028" : "\\u2029");
+				i += 2;
+			}
+			else if (c == '"') { out.append("\\\""); }
+			else if (c == '\\') { out.append("\\\\"); }
+			else if (c == '\b') { out.append("\\b"); }
+			else if (c == '\f') { out.append("\\f"); }
+			else if (c == '\n') { out.append("\\n"); }
+			else if (c == '\r') { out.append("\\r"); }
+			else if (c == '\t') { out.append("\\t"); }
+			else if (c < 0x20) { out.append({'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]}); }
+			else { out.push_back(static_cast<char>(c)); }
+		}
+		out.push_back('"');
+		return out;
+	}
+
+	[[nodiscard]] auto escape(const std::string_view string) -> std::string
+	{
+		std::string out{};
+		json::append_string(out, string);
+		return out;
+	}
+
+	suite test_json_escape = []
+	{
+		"escape"_test = []
+		{
+			expect(escape("") == R"("")");
+			expect(escape("plain") == R"("plain")");
+			expect(escape("a\"b\\c") == R"("a\"b\\c")");
+			expect(escape("\n\t\x01\x1f") == R"("\n\t\u0001\u001f")");
+			expect(escape("\xe2\x80\xa8\xe2\x80\xa9") == R"("\u2028\u2029")");
+			expect(escape("\xe2\x82\xac") == "\"\xe2\x82\xac\"") << "other characters starting with E2 are left alone";
+			expect(escape("\xe2\x80") == "\"\xe2\x80\"") << "truncated";
+		};
+
+		"special byte at every position"_test = []
+		{
+			// around the 8 / 16 / 32 bytes blocks
+			for (const auto special: {std::string_view{"\""}, std::string_view{"\\"}, std::string_view{"\x01"}, std::string_view{"\x1f"}, std::string_view{"\xe2\x80\xa8"}})
+			{
+				for (std::size_t size = 0; size <= 70; ++size)
+				{
+					for (std::size_t position = 0; position <= size; ++position)
+					{
+						std::string string(size, 'x');
+						string.insert(position, special);
+						expect(escape(string) == reference_escape(string)) << "size" << size << "position" << position;
+					}
+				}
+			}
+		};
+
+		"random"_test = []
+		{
+			std::mt19937                       engine{42};
+			std::uniform_int_distribution<int> byte{0, 255};
+			std::uniform_int_distribution<int> length{0, 300};
+
+			for (int i = 0; i < 2'000; ++i)
+			{
+				std::string string(static_cast<std::size_t>(length(engine)), '\0');
+				for (auto& c: string)
+				{
+					// mostly printable, with enough specials
+					const auto b = byte(engine);
+					c            = static_cast<char>(b < 200 ? 'a' + b % 26 : b);
+				}
+				expect(escape(string) == reference_escape(string));
+			}
+		};
+
+		"round trip"_test = []
+		{
+			const std::string_view original{"\"quoted\" \\ \n\t\x01 \xe2\x80\xa8 \xe2\x82\xac"};
+
+			auto            escaped = escape(original);
+			std::string_view input{escaped};
+			std::string      decoded{};
+			expect(json::read_string(input, decoded));
+			expect(decoded == original);
+			expect(input.empty());
+		};
+	};
+}// namespace
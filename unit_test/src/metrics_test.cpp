@@ -0,0 +1,195 @@
+#include <boost/ut.hpp>
+#include <webview/impl/v3/metrics.hpp>
+#include <webview/impl/v3/web_view_mock.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace boost::ut;
+
+namespace
+{
+	namespace metrics = gal::web_view::impl::metrics;
+
+	using gal::web_view::NavigationEvent;
+	using gal::web_view::ServiceStartResult;
+	using gal::web_view::impl::WebViewMock;
+	using layout = metrics::HistogramLayout;
+
+	suite test_metrics_histogram = []
+	{
+		"layout"_test = []
+		{
+			std::size_t last = 0;
+			for (std::uint64_t value = 0; value < 100'000; ++value)
+			{
+				const auto index = layout::index_of(value);
+				expect(index == last || index == last + 1) << "contiguous" << value;
+				expect(layout::lowest_of(index) <= value && value <= layout::highest_of(index)) << value;
+				last = index;
+			}
+
+			for (const std::uint64_t value: {std::uint64_t{1'000}, std::uint64_t{123'456'789}, std::uint64_t{1} << 40})
+			{
+				const auto index = layout::index_of(value);
+				expect(layout::lowest_of(index) <= value && value <= layout::highest_of(index)) << value;
+				// 8 buckets per power of two
+				expect(static_cast<double>(layout::highest_of(index) - layout::lowest_of(index)) <= static_cast<double>(value) * 0.125) << value;
+			}
+
+			expect(layout::index_of(std::uint64_t{1} << 60) == layout::bucket_count - 1) << "too large for the last bucket";
+			expect(layout::index_of((std::uint64_t{1} << layout::max_bits) - 1) == layout::bucket_count - 1);
+		};
+
+		"quantiles"_test = []
+		{
+			metrics::HistogramSnapshot snapshot{.buckets = {}, .count = 0, .sum = 0};
+			expect(snapshot.quantile(0.5) == 0_ull);
+
+			for (std::uint64_t value = 1; value <= 1000; ++value)
+			{
+				++snapshot.buckets[layout::index_of(value)];
+				++snapshot.count;
+				snapshot.sum += value;
+			}
+
+			expect(snapshot.mean() == 500.5_d);
+			const auto median = snapshot.quantile(0.5);
+			expect(median >= 500 && median <= 500 * 9 / 8) << median;
+			const auto p99 = snapshot.quantile(0.99);
+			expect(p99 >= 990 && p99 <= 990 * 9 / 8) << p99;
+			expect(snapshot.quantile(1) == layout::highest_of(layout::index_of(1000)));
+		};
+
+		"record"_test = []
+		{
+			metrics::Histogram histogram{};
+			metrics::Counter   counter{};
+			for (std::uint64_t value = 0; value < 100; ++value)
+			{
+				histogram.record(value);
+				counter.add(2);
+			}
+
+			const auto snapshot = histogram.snapshot();
+			if constexpr (metrics::enabled)
+			{
+				expect(snapshot.count == 100_ull);
+				expect(snapshot.sum == 4950_ull);
+				expect(counter.value() == 200_ull);
+			}
+			else
+			{
+				expect(snapshot.count == 0_ull);
+				expect(counter.value() == 0_ull);
+			}
+		};
+	};
+
+	suite test_metrics_web_view = []
+	{
+		"bridge and loop"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind("echo", [](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type arg) -> void { wv.resolve(id, arg); });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "echo", "hello");
+			web_view.post_message(2, "nothing", "");
+			web_view.post_binary_message(3, "echo", std::as_bytes(std::span{"abc", 3}));
+			web_view.dispatch([](WebViewMock&) -> void {});
+			web_view.dispatch([](WebViewMock&) -> void {});
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://example.com");
+			web_view.simulate_navigation_event(NavigationEvent::COMMITTED, "https://example.com");
+			web_view.simulate_navigation_event(NavigationEvent::FINISHED, "https://example.com");
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://unreachable.example");
+			web_view.simulate_navigation_event(NavigationEvent::FAILED, "https://unreachable.example", "Could not resolve host");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			const auto snapshot = web_view.metrics().snapshot();
+			if constexpr (!metrics::enabled)
+			{
+				expect(snapshot.messages_received == 0_ull);
+				return;
+			}
+
+			expect(snapshot.messages_received == 3_ull);
+			expect(snapshot.bytes_received >= 3_ull);
+			expect(snapshot.replies == 3_ull);
+			expect(snapshot.messages_sent >= 1_ull);
+			expect(snapshot.bytes_sent > 0_ull);
+			expect(snapshot.evals >= 1_ull);
+			expect(snapshot.eval_latency.count == snapshot.evals);
+			expect(snapshot.handler_duration.count == 3_ull);
+			expect(snapshot.dispatch_queue_depth.count == 1_ull);
+			expect(snapshot.dispatch_queue_depth.quantile(1) == 2_ull);
+			expect(snapshot.iteration_duration.count >= 2_ull);
+			expect(snapshot.navigation_commit.count == 1_ull);
+			expect(snapshot.navigation_duration.count == 1_ull);
+			expect(snapshot.navigation_failures == 1_ull);
+		};
+
+		"binary reply"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind(
+					"download",
+					[](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type) -> void
+					{
+						const std::byte bytes[1000]{};
+						wv.resolve(id, WebViewMock::bytes_view_type{bytes});
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			expect(web_view.iteration());
+
+			const auto before = web_view.metrics().snapshot();
+			web_view.post_message(1, "download", "");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			const auto after = web_view.metrics().snapshot();
+			if constexpr (!metrics::enabled)
+			{
+				expect(after.replies == 0_ull);
+				return;
+			}
+
+			expect(after.replies - before.replies == 1_ull);
+			// the bytes themselves, the engine is given them as they are
+			expect(after.messages_sent - before.messages_sent >= 1_ull);
+			expect(after.bytes_sent - before.bytes_sent >= 1000_ull);
+		};
+
+		"prometheus"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind("echo", [](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type arg) -> void { wv.resolve(id, arg); });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message(1, "echo", "hello");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			std::string text{};
+			metrics::append_prometheus(text, web_view.metrics().snapshot(), "app_");
+			expect(text.find("# TYPE app_messages_received_total counter\n") != std::string::npos);
+			expect(text.find("# TYPE app_handler_duration_seconds summary\n") != std::string::npos);
+			expect(text.find("app_handler_duration_seconds{quantile=\"0.99\"} ") != std::string::npos);
+			if constexpr (metrics::enabled)
+			{
+				expect(text.find("\napp_messages_received_total 1\n") != std::string::npos);
+				expect(text.find("\napp_handler_duration_seconds_count 1\n") != std::string::npos);
+			}
+
+			const auto path = std::filesystem::temp_directory_path() / "gal_webview_metrics_test.prom";
+			expect(metrics::write_prometheus(path, web_view.metrics().snapshot(), "app_"));
+			expect(!std::filesystem::exists(std::filesystem::path{path} += ".tmp"));
+
+			std::ifstream      file{path};
+			std::ostringstream content{};
+			content << file.rdbuf();
+			expect(content.str() == text);
+			std::filesystem::remove(path);
+		};
+	};
+}// namespace
@@ -0,0 +1,1375 @@
+#include <boost/ut.hpp>
+#include <webview/impl/v3/web_view_mock.hpp>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+using namespace boost::ut;
+
+namespace
+{
+	using gal::web_view::EvalResult;
+	using gal::web_view::Execution;
+	using gal::web_view::InjectFrames;
+	using gal::web_view::InjectTime;
+	using gal::web_view::NavigateResult;
+	using gal::web_view::NavigationEvent;
+	using gal::web_view::ServiceStartResult;
+	using gal::web_view::ServiceStateResult;
+	using gal::web_view::impl::Task;
+	using gal::web_view::impl::WebViewMock;
+
+	[[nodiscard]] auto contains(const std::vector<WebViewMock::string_type>& scripts, const std::string_view what) -> bool
+	{
+		return std::ranges::any_of(scripts, [what](const auto& script) { return script.find(what) != std::string_view::npos; });
+	}
+
+	[[nodiscard]] auto contains(const std::vector<std::pmr::string>& scripts, const std::string_view what) -> bool
+	{
+		return std::ranges::any_of(scripts, [what](const auto& script) { return script.find(what) != std::string_view::npos; });
+	}
+
+	suite test_mock_navigation = []
+	{
+		"navigate before start"_test = []
+		{
+			WebViewMock web_view{};
+
+			expect(web_view.navigate("https://example.com") == NavigateResult::SERVICE_NOT_READY_YET);
+			expect(web_view.navigations().empty());
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			expect(web_view.service_state() == ServiceStateResult::RUNNING);
+			expect(web_view.navigations() == std::vector<WebViewMock::string_type>{"https://example.com"});
+		};
+
+		"navigate after start"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			expect(web_view.navigate("app:///a.html") == NavigateResult::SUCCESS);
+			expect(web_view.navigate("app:///b.html") == NavigateResult::SUCCESS);
+			expect(web_view.navigations().size() == 3_ul);
+			expect(web_view.navigations().back() == "app:///b.html");
+		};
+
+		"window"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_window_title(std::string_view{"before"});
+			expect(web_view.window_title() == "before");
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.set_window_title(std::string_view{"after"});
+			web_view.set_window_fullscreen(true);
+			expect(web_view.window_title() == "after");
+			expect(web_view.window_is_fullscreen());
+		};
+	};
+
+	suite test_mock_eval = []
+	{
+		"eval echo"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			const auto [result, value] = web_view.eval("1 + 1");
+			expect(result == EvalResult::SUCCESS);
+			expect(value == "1 + 1");
+			expect(web_view.evaluations().back() == "1 + 1");
+		};
+
+		"eval handler"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_eval_handler(
+					[](WebViewMock&, const WebViewMock::string_view_type code) -> WebViewMock::eval_result_type
+					{
+						if (code == "throw") { return {EvalResult::EVAL_FAILED, "Error"}; }
+						return {EvalResult::SUCCESS, "42"};
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			auto ok     = web_view.eval_async("answer");
+			auto failed = web_view.eval_async("throw");
+			expect(!ok.ready() && !failed.ready()) << "nothing happens before the next iteration";
+
+			expect(web_view.iteration());
+			expect(ok.ready() && failed.ready());
+			expect(ok.get().result == EvalResult::SUCCESS && ok.get().value == "42");
+			expect(failed.get().result == EvalResult::EVAL_FAILED);
+		};
+
+		"eval call"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			const std::vector<int> values{1, 2, 3};
+			auto                   future = web_view.eval_call("window.app.update", "</script>\"'); alert(1); //", 42, true, values, std::optional<int>{});
+			web_view.eval_call("window.app.reset");
+			expect(web_view.iteration());
+			expect(future.ready());
+
+			expect(contains(web_view.evaluations(), R"(window.app.update("</script>\"'); alert(1); //",42,true,[1,2,3],null))"));
+			expect(contains(web_view.evaluations(), "window.app.reset()"));
+		};
+
+		"eval not ready"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.eval("not_ready()").result == EvalResult::SERVICE_NOT_READY_YET);
+
+			// the script is dropped, not run once the service starts
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+			expect(!contains(web_view.evaluations(), "not_ready()"));
+		};
+
+		"eval latency"_test = []
+		{
+			using namespace std::chrono_literals;
+
+			WebViewMock web_view{};
+			web_view.set_latency(20ms);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			const auto begin  = WebViewMock::clock_type::now();
+			const auto result = web_view.eval("1");
+			expect(result.result == EvalResult::SUCCESS);
+			expect(WebViewMock::clock_type::now() - begin >= 20ms);
+		};
+
+		"destroyed while a script runs"_test = []
+		{
+			using namespace std::chrono_literals;
+
+			auto web_view = std::make_unique<WebViewMock>();
+			web_view->set_latency(1h);
+			expect(web_view->service_start() == ServiceStartResult::SUCCESS);
+
+			auto future = web_view->eval_async("1");
+			expect(web_view->poll());
+			expect(!future.ready()) << "the engine has the script";
+
+			// the engine settles it while the web view goes, nothing is recorded by then
+			const auto*                  destroyed = web_view.get();
+			const auto                   recorded  = destroyed->metrics().snapshot().eval_latency.count;
+			std::optional<std::uint64_t> recorded_after{};
+			std::optional<EvalResult>    result{};
+			future.then(
+					[&](WebViewMock::eval_result_type&& r) -> void
+					{
+						recorded_after = destroyed->metrics().snapshot().eval_latency.count;
+						result         = r.result;
+					});
+
+			web_view.reset();
+			expect(result == EvalResult::EVAL_FAILED);
+			expect(recorded_after == recorded);
+		};
+	};
+
+	suite test_mock_eval_batch = []
+	{
+		constexpr WebViewMock::eval_batch_type batched{.max_bytes = 64 * 1024, .max_delay = std::chrono::milliseconds{0}};
+
+		// The result of a batch is given, the scripts are not evaluated.
+		constexpr auto batch_result = [](WebViewMock::string_type& batch, const EvalResult result, const std::string_view value) -> auto
+		{
+			return [&batch, result, value](WebViewMock&, const WebViewMock::string_view_type code) -> WebViewMock::eval_result_type
+			{
+				batch = code;
+				return {result, WebViewMock::string_type{value}};
+			};
+		};
+
+		"one script for the batch"_test = [&]
+		{
+			WebViewMock              web_view{};
+			WebViewMock::string_type batch{};
+			web_view.set_eval_batch(batched);
+			web_view.set_eval_handler(batch_result(batch, EvalResult::SUCCESS, R"([1,"2",0,"ReferenceError: missing is not defined",1,"{\"a\":1}"])"));
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.clear_records();
+
+			auto first  = web_view.eval_async("1 + 1");
+			auto second = web_view.eval_async("missing");
+			auto third  = web_view.eval_async("({a: 1})");
+			expect(web_view.evaluations().empty()) << "queued until the next iteration";
+
+			expect(web_view.iteration());
+			expect(web_view.evaluations().size() == 1_ul);
+			expect(batch.starts_with("(()=>{const r=[]"));
+			expect(batch.find("try{r.push(1,s((\n1 + 1\n)))}catch(e){r.push(0,String(e))}") != std::string::npos);
+			expect(batch.find("try{r.push(1,s((\nmissing\n)))}catch(e){r.push(0,String(e))}") != std::string::npos);
+			expect(batch.find("try{r.push(1,s((\n({a: 1})\n)))}catch(e){r.push(0,String(e))}") != std::string::npos);
+			expect(batch.ends_with("return r;})()"));
+
+			expect(first.ready() && second.ready() && third.ready());
+			expect(first.get().result == EvalResult::SUCCESS && first.get().value == "2");
+			expect(second.get().result == EvalResult::EVAL_FAILED && second.get().value == "ReferenceError: missing is not defined") << "only the script itself fails";
+			expect(third.get().result == EvalResult::SUCCESS && third.get().value == R"({"a":1})");
+		};
+
+		"malformed batch result"_test = [&]
+		{
+			for (const std::string_view result: {std::string_view{R"([1,"ok",1,)"}, std::string_view{"undefined"}, std::string_view{R"([1,"ok",2,"no"])"}})
+			{
+				WebViewMock              web_view{};
+				WebViewMock::string_type batch{};
+				web_view.set_eval_batch(batched);
+				web_view.set_eval_handler(batch_result(batch, EvalResult::SUCCESS, result));
+				expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+				auto first  = web_view.eval_async("first");
+				auto second = web_view.eval_async("second");
+				expect(web_view.iteration());
+				expect(first.ready() && second.ready()) << result;
+
+				// what can be read is read
+				if (result.starts_with(R"([1,"ok")")) { expect(first.get().result == EvalResult::SUCCESS && first.get().value == "ok") << result; }
+				else { expect(first.get().result == EvalResult::EVAL_FAILED && first.get().value == "malformed batch result") << result; }
+				expect(second.get().result == EvalResult::EVAL_FAILED && second.get().value == "malformed batch result") << result;
+			}
+		};
+
+		"failed batch"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_eval_batch(batched);
+			// a statement is not an expression
+			web_view.set_eval_handler(
+					[](WebViewMock&, const WebViewMock::string_view_type code) -> WebViewMock::eval_result_type
+					{
+						if (code.starts_with("(()=>{")) { return {EvalResult::EVAL_FAILED, "SyntaxError: Unexpected token 'let'"}; }
+						if (code == "let a = 1; a") { return {EvalResult::SUCCESS, "1"}; }
+						return {EvalResult::EVAL_FAILED, "SyntaxError: Unexpected end of input"};
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.clear_records();
+
+			auto first  = web_view.eval_async("let a = 1; a");
+			auto second = web_view.eval_async("(");
+			expect(web_view.iteration());
+			expect(!first.ready() && !second.ready()) << "nothing of the batch ran";
+			expect(web_view.evaluations().size() == 3_ul);
+			expect(web_view.evaluations()[1] == "let a = 1; a" && web_view.evaluations()[2] == "(") << "every script is evaluated alone";
+
+			expect(web_view.iteration());
+			expect(first.ready() && second.ready());
+			expect(first.get().result == EvalResult::SUCCESS && first.get().value == "1");
+			expect(second.get().result == EvalResult::EVAL_FAILED && second.get().value == "SyntaxError: Unexpected end of input");
+		};
+
+		"max bytes"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_eval_batch({.max_bytes = 16, .max_delay = std::chrono::milliseconds{0}});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.clear_records();
+
+			web_view.eval_async("0123456789");
+			expect(web_view.evaluations().empty());
+			web_view.eval_async("0123456789");
+			expect(web_view.evaluations().size() == 1_ul) << "the batch is full, it is sent right away";
+			expect(web_view.evaluations().back().starts_with("(()=>{const r=[]"));
+
+			web_view.eval_async("x");
+			expect(web_view.evaluations().size() == 1_ul);
+			expect(web_view.iteration());
+			expect(web_view.evaluations().size() == 2_ul);
+			expect(web_view.evaluations().back() == "x") << "a script alone is not wrapped";
+		};
+
+		"max delay"_test = []
+		{
+			using namespace std::chrono_literals;
+
+			WebViewMock web_view{};
+			web_view.set_eval_batch({.max_bytes = 64 * 1024, .max_delay = 30ms});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			expect(web_view.poll());
+			web_view.clear_records();
+			expect(web_view.pending_work_timeout() == std::chrono::milliseconds::max()) << "nothing to wait for";
+
+			auto       future  = web_view.eval_async("1");
+			const auto timeout = web_view.pending_work_timeout();
+			expect(timeout > 0ms && timeout <= 30ms);
+
+			expect(web_view.poll());
+			expect(web_view.evaluations().empty()) << "not before the delay";
+			expect(!future.ready());
+
+			std::this_thread::sleep_for(30ms);
+			expect(web_view.pending_work_timeout() == 0ms);
+			expect(web_view.poll());
+			expect(web_view.evaluations().size() == 1_ul);
+			expect(future.ready());
+		};
+	};
+
+	suite test_mock_bridge = []
+	{
+		"bind and resolve"_test = []
+		{
+			WebViewMock web_view{};
+			WebViewMock::string_type received{};
+			web_view.bind(
+					"echo",
+					[&received](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type arg) -> void
+					{
+						received = arg;
+						wv.resolve(id, arg);
+					});
+			expect(contains({WebViewMock::string_type{web_view.injected_javascript_code()}}, R"(window.external.__bind("echo");)"));
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message(7, "echo", "hello");
+			expect(web_view.iteration());
+			expect(received == "hello");
+
+			// the reply is sent during the next iteration
+			expect(web_view.iteration());
+			expect(contains(web_view.evaluations(), R"(window.external.__reply([[7,1,"hello"]]))"));
+		};
+
+		"auto resolve"_test = []
+		{
+			WebViewMock web_view{};
+			int         calls = 0;
+			web_view.bind("ping", [&calls](WebViewMock&, const WebViewMock::string_view_type) -> void { ++calls; });
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message(1, "ping", "");
+			web_view.post_message(2, "ping", "");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(calls == 2_i);
+			expect(contains(web_view.evaluations(), "window.external.__reply([[1,1,undefined],[2,1,undefined]])")) << "replies are sent in one script";
+		};
+
+		"no such method"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(3, "missing", "");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+			expect(contains(web_view.evaluations(), R"([3,0,"no such method"])"));
+		};
+
+		"raw message"_test = []
+		{
+			WebViewMock web_view{};
+			WebViewMock::string_type received{};
+			web_view.register_javascript_callback([&received](WebViewMock&, WebViewMock::string_type&& message) -> void { received = std::move(message); });
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message("not:framed");
+			expect(web_view.iteration());
+			expect(received == "not:framed");
+
+			// only the handlers `bind` accepts
+			constexpr auto supported   = [](WebViewMock&, WebViewMock::string_view_type) -> void {};
+			constexpr auto unsupported = [](WebViewMock&) -> void {};
+			constexpr auto registrable = []<typename Callback>(WebViewMock& wv, const Callback& callback) -> bool { return requires { wv.register_javascript_callback(callback); }; };
+			constexpr auto bindable    = []<typename Handler>(WebViewMock& wv, const Handler& handler) -> bool { return requires { wv.bind("nothing", handler); }; };
+			expect(registrable(web_view, supported) && bindable(web_view, supported));
+			expect(!registrable(web_view, unsupported) && !bindable(web_view, unsupported));
+		};
+
+		"binary message"_test = []
+		{
+			WebViewMock web_view{};
+			std::size_t size = 0;
+			web_view.bind("upload", [&size](WebViewMock&, const WebViewMock::bytes_view_type bytes) -> void { size = bytes.size(); });
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			const std::byte bytes[]{std::byte{1}, std::byte{2}, std::byte{3}};
+			web_view.post_binary_message(5, "upload", bytes);
+			expect(web_view.iteration());
+			expect(size == 3_ul);
+		};
+
+		"binary reply"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind(
+					"download",
+					[](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type) -> void
+					{
+						const std::byte bytes[]{std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+						wv.resolve(id, WebViewMock::bytes_view_type{bytes});
+					});
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message(9, "download", "");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+			expect(contains(web_view.evaluations(), R"([9,1,window.external.__bytes("YWJj")])"));
+		};
+
+		"binary replies keep the order"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind(
+					"mixed",
+					[](WebViewMock& wv, const WebViewMock::call_id_type, const WebViewMock::string_view_type) -> void
+					{
+						const std::byte bytes[]{std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+						wv.resolve(1, "x");
+						wv.resolve(2, WebViewMock::bytes_view_type{bytes});
+						wv.reject(3, "no");
+						wv.resolve(4, WebViewMock::bytes_view_type{bytes});
+					});
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message(WebViewMock::invalid_call_id, "mixed", "");
+			expect(web_view.iteration());
+			web_view.clear_records();
+			expect(web_view.iteration());
+
+			const auto& evaluations = web_view.evaluations();
+			expect(evaluations.size() == 4_ul) << "nothing is sent before the next iteration";
+			if (evaluations.size() != 4) { return; }
+			expect(evaluations[0] == R"(window.external.__reply([[1,1,"x"]]))");
+			expect(evaluations[1] == R"(window.external.__reply([[2,1,window.external.__bytes("YWJj")]]))");
+			expect(evaluations[2] == R"(window.external.__reply([[3,0,"no"]]))");
+			expect(evaluations[3] == R"(window.external.__reply([[4,1,window.external.__bytes("YWJj")]]))");
+		};
+
+		"unbind"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind("f", [](WebViewMock&, const WebViewMock::string_view_type) -> void {});
+			expect(web_view.unbind("f"));
+			expect(!web_view.unbind("f"));
+		};
+
+		"bind again"_test = []
+		{
+			const auto count = [](const WebViewMock::string_view_type code, const WebViewMock::string_view_type what) -> std::size_t
+			{
+				std::size_t n = 0;
+				for (auto i = code.find(what); i != WebViewMock::string_view_type::npos; i = code.find(what, i + what.size())) { ++n; }
+				return n;
+			};
+
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.clear_records();
+
+			web_view.bind("f", [](WebViewMock&, const WebViewMock::string_view_type) -> void {});
+			const auto size = web_view.injected_javascript_code().size();
+			for (int i = 0; i < 3; ++i)
+			{
+				expect(web_view.unbind("f"));
+				web_view.bind("f", [](WebViewMock&, const WebViewMock::string_view_type) -> void {});
+			}
+			web_view.bind("f", [](WebViewMock&, const WebViewMock::string_view_type) -> void {});
+			expect(web_view.injected_javascript_code().size() == size) << "the stub is kept";
+			expect(count(web_view.injected_javascript_code(), R"(window.external.__bind("f");)") == 1_ul);
+			expect(web_view.evaluations().size() == 1_ul) << "the current page got it once";
+		};
+
+		"bind and unbind from a handler"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind(
+					"setup",
+					// the capture is used after the handler unbound itself
+					[prefix = std::string(64, 'f')](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type) -> void
+					{
+						// enough of them to grow the table
+						for (int i = 0; i < 32; ++i)
+						{
+							wv.bind(
+									prefix + std::to_string(i),
+									[i](WebViewMock& w, const WebViewMock::call_id_type call, const WebViewMock::string_view_type) -> void { w.resolve(call, std::to_string(i)); });
+						}
+
+						expect(wv.unbind("setup"));
+						expect(!wv.unbind("setup"));
+						expect(wv.unbind(prefix + "31"));
+						wv.resolve(id, prefix.substr(0, 3));
+					});
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			const std::string prefix(64, 'f');
+			web_view.post_message(1, "setup", "");
+			web_view.post_message(2, prefix + "7", "");
+			web_view.post_message(3, "setup", "");
+			web_view.post_message(4, prefix + "31", "");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(contains(web_view.evaluations(), R"(window.external.__reply([[1,1,"fff"],[2,1,"7"],[3,0,"no such method"],[4,0,"no such method"]]))"));
+			expect(contains(web_view.evaluations(), R"(window.external.__bind(")" + prefix + R"(0");)"));
+			expect(web_view.unbind(prefix + "0"));
+			expect(!web_view.unbind(prefix + "31"));
+		};
+
+		"inject"_test = []
+		{
+			WebViewMock web_view{};
+			const auto id = web_view.inject("console.log(1);");
+			expect(id != WebViewMock::invalid_injection_id);
+			expect(web_view.injections().size() == 1_ul);
+			expect(web_view.injections()[0].code == "(() => {console.log(1);})()");
+			expect(web_view.injected_javascript_code().find("console.log(1);") == std::string_view::npos) << "not part of the bridge";
+		};
+
+		"injections"_test = []
+		{
+			WebViewMock web_view{};
+
+			const auto script = web_view.add_script("first();", InjectFrames::ALL_FRAMES, InjectTime::DOCUMENT_END);
+			const auto style  = web_view.add_style_sheet("body { margin: 0; }");
+			expect(script != style);
+			expect(web_view.injections()[0].frames == InjectFrames::ALL_FRAMES);
+			expect(web_view.injections()[0].time == InjectTime::DOCUMENT_END);
+			expect(web_view.injections()[1].style_sheet);
+			expect(web_view.installed_injections().empty()) << "nothing is installed before the service starts";
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			expect(web_view.installed_injections() == std::vector{script, style});
+
+			// at runtime
+			const auto later = web_view.add_script("later();");
+			expect(web_view.installed_injections() == std::vector{script, style, later});
+
+			expect(web_view.remove_injection(script));
+			expect(!web_view.remove_injection(script));
+			expect(!web_view.remove_injection(WebViewMock::invalid_injection_id));
+			expect(web_view.installed_injections() == std::vector{style, later});
+			expect(web_view.injections().size() == 2_ul);
+		};
+	};
+
+	[[nodiscard]] auto add(const int a, const int b) noexcept -> int { return a + b; }
+
+	[[nodiscard]] auto join(const std::vector<std::string>& strings, const std::string_view separator) -> std::string
+	{
+		std::string result{};
+		for (const auto& string: strings)
+		{
+			if (!result.empty()) { result.append(separator); }
+			result.append(string);
+		}
+		return result;
+	}
+
+	auto rename(WebViewMock& web_view, const std::string_view title) -> void { web_view.set_window_title(title); }
+
+	[[nodiscard]] auto find(const std::optional<int> value) -> std::optional<std::string_view> { return value ? std::optional<std::string_view>{"found"} : std::nullopt; }
+
+	struct not_json {};
+
+	static_assert(gal::web_view::impl::json::readable<std::vector<std::optional<double>>>);
+	static_assert(!gal::web_view::impl::json::readable<std::string*>);
+	static_assert(!gal::web_view::impl::json::writable<std::vector<not_json>>);
+
+	suite test_mock_typed_bridge = []
+	{
+		"typed bind"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind<&add>("add");
+			expect(contains({WebViewMock::string_type{web_view.injected_javascript_code()}}, R"(window.external.__bind_json("add");)"));
+
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.post_message(1, "add", "[1, 2]");
+			web_view.post_message(2, "add", "[1]");
+			web_view.post_message(3, "add", R"([1,"2"])");
+			web_view.post_message(4, "add", "[1.5,2]");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(contains(web_view.evaluations(), "[1,1,3]"));
+			expect(contains(web_view.evaluations(), R"([2,0,"invalid arguments"])"));
+			expect(contains(web_view.evaluations(), R"([3,0,"invalid arguments"])"));
+			expect(contains(web_view.evaluations(), R"([4,0,"invalid arguments"])"));
+		};
+
+		"typed bind again"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind("add", [](WebViewMock&, const WebViewMock::string_view_type) -> void {});
+			web_view.bind("sub", [](WebViewMock&, const WebViewMock::string_view_type) -> void {});
+			expect(web_view.unbind("add"));
+			web_view.bind<&add>("add");
+
+			// the stub of the other kind is replaced, in place
+			const WebViewMock::string_type code{web_view.injected_javascript_code()};
+			expect(!contains({code}, R"(window.external.__bind("add");)"));
+			const auto json_stub = code.find(R"(window.external.__bind_json("add");)");
+			expect(json_stub != std::string::npos);
+			expect(json_stub < code.find(R"(window.external.__bind("sub");)"));
+			expect(code.find(R"(window.external.__bind_json("add");)", json_stub + 1) == std::string::npos);
+		};
+
+		"typed strings"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind<&join>("join");
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "join", R"([["a","b\"c"], ", "])");
+			web_view.post_message(2, "join", R"([[], " "])");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(contains(web_view.evaluations(), R"([1,1,"a, b\"c"])"));
+			expect(contains(web_view.evaluations(), R"([2,1,""])"));
+		};
+
+		"typed web view parameter"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind<&rename>("rename");
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "rename", R"(["typed \ud83d\ude00"])");
+			expect(web_view.iteration());
+			expect(web_view.window_title() == "typed \xf0\x9f\x98\x80");
+		};
+
+		"typed optional and lambda"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind<&find>("find");
+			web_view.bind<[](const bool value) -> bool { return !value; }>("not");
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "find", "[null]");
+			web_view.post_message(2, "find", "[42]");
+			web_view.post_message(3, "not", "[true]");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(contains(web_view.evaluations(), "[1,1,null]"));
+			expect(contains(web_view.evaluations(), R"([2,1,"found"])"));
+			expect(contains(web_view.evaluations(), "[3,1,false]"));
+		};
+	};
+
+	suite test_mock_dispatch = []
+	{
+		"dispatch from threads"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			int calls = 0;
+
+			std::vector<std::thread> threads{};
+			for (int i = 0; i < 4; ++i)
+			{
+				threads.emplace_back(
+						[&web_view]
+						{
+							for (int j = 0; j < 100; ++j) { web_view.dispatch([](WebViewMock& wv) -> void { wv.set_window_title(std::string_view{"dispatched"}); }); }
+						});
+			}
+			for (auto& thread: threads) { thread.join(); }
+
+			web_view.dispatch([&calls](WebViewMock&) -> void { ++calls; });
+			web_view.dispatch_eval("dispatched()");
+
+			expect(web_view.wake_ups() >= 1_ul);
+			expect(web_view.iteration());
+			expect(calls == 1_i);
+			expect(web_view.window_title() == "dispatched");
+			expect(contains(web_view.evaluations(), "dispatched()"));
+		};
+	};
+
+	// The replies of the worker threads arrive whenever they are done, runs the loop until the predicate holds (for at most a few seconds).
+	template<typename Predicate>
+	auto wait_until(WebViewMock& web_view, Predicate predicate) -> bool
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+		while (!predicate() && std::chrono::steady_clock::now() < deadline) { (void)web_view.iteration(std::chrono::milliseconds{1}); }
+		return predicate();
+	}
+
+	suite test_mock_workers = []
+	{
+		"pool"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_worker_pool({.threads = 2, .capacity = 16});
+
+			const auto        loop_thread = std::this_thread::get_id();
+			std::atomic<bool> on_loop_thread{false};
+			web_view.bind(
+					"upper",
+					[loop_thread, &on_loop_thread](const WebViewMock::string_view_type text) -> std::string
+					{
+						if (std::this_thread::get_id() == loop_thread) { on_loop_thread = true; }
+
+						std::string result{text};
+						std::ranges::transform(result, result.begin(), [](const char c) { return static_cast<char>(c - 'a' + 'A'); });
+						return result;
+					},
+					Execution::POOL);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "upper", "abc");
+			web_view.post_message(2, "upper", "def");
+			expect(wait_until(web_view, [&web_view] { return contains(web_view.evaluations(), R"([1,1,"ABC"])") && contains(web_view.evaluations(), R"([2,1,"DEF"])"); }));
+			expect(!on_loop_thread);
+			expect(web_view.wake_ups() >= 1_ul);
+		};
+
+		"strand keeps the order"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_worker_pool({.threads = 4, .capacity = 64});
+
+			std::vector<int>  order{};
+			std::atomic<int>  running{0};
+			std::atomic<bool> overlapped{false};
+			web_view.bind(
+					"append",
+					[&](std::string&& value) -> void
+					{
+						if (running.fetch_add(1) != 0) { overlapped = true; }
+						order.push_back(std::stoi(value));
+						running.fetch_sub(1);
+					},
+					Execution::STRAND);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			std::vector<int> expected{};
+			for (int i = 1; i <= 20; ++i)
+			{
+				web_view.post_message(static_cast<WebViewMock::call_id_type>(i), "append", std::to_string(i));
+				expected.push_back(i);
+			}
+
+			// the last reply comes after every other call
+			expect(wait_until(web_view, [&web_view] { return contains(web_view.evaluations(), "[20,1,undefined]"); }));
+			expect(order == expected);
+			expect(!overlapped);
+		};
+
+		"capacity"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_worker_pool({.threads = 1, .capacity = 1});
+
+			std::atomic<bool> started{false};
+			std::atomic<bool> released{false};
+			web_view.bind(
+					"block",
+					[&started, &released](const WebViewMock::string_view_type) -> void
+					{
+						started = true;
+						while (!released) { std::this_thread::yield(); }
+					},
+					Execution::POOL);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "block", "");
+			expect(web_view.iteration());
+			while (!started) { std::this_thread::yield(); }
+
+			// the only thread is busy, one call waits, the next one is rejected
+			web_view.post_message(2, "block", "");
+			web_view.post_message(3, "block", "");
+			expect(wait_until(web_view, [&web_view] { return contains(web_view.evaluations(), R"([3,0,"too many pending calls"])"); }));
+
+			released = true;
+			expect(wait_until(web_view, [&web_view] { return contains(web_view.evaluations(), "[1,1,undefined]") && contains(web_view.evaluations(), "[2,1,undefined]"); }));
+		};
+
+		"typed, bytes and exceptions"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_worker_pool({.threads = 2, .capacity = 16});
+			web_view.bind<&add>("add", Execution::POOL);
+			web_view.bind(
+					"reverse",
+					[](const WebViewMock::bytes_view_type bytes) -> std::vector<std::byte> { return {bytes.rbegin(), bytes.rend()}; },
+					Execution::POOL);
+			web_view.bind("fail", [](const WebViewMock::string_view_type) -> int { throw std::runtime_error{"boom"}; }, Execution::STRAND);
+			web_view.bind("inline", [](std::string&& text) -> std::string { return text + "!"; }, Execution::INLINE);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			const std::byte bytes[]{std::byte{'c'}, std::byte{'b'}, std::byte{'a'}};
+			web_view.post_message(1, "add", "[1,2]");
+			web_view.post_message(2, "add", "[1]");
+			web_view.post_message(3, "fail", "");
+			web_view.post_message(4, "inline", "hi");
+			web_view.post_binary_message(5, "reverse", bytes);
+			expect(wait_until(
+					web_view,
+					[&web_view]
+					{
+						return contains(web_view.evaluations(), "[1,1,3]") &&
+							   contains(web_view.evaluations(), R"([2,0,"invalid arguments"])") &&
+							   contains(web_view.evaluations(), R"([3,0,"boom"])") &&
+							   contains(web_view.evaluations(), R"([4,1,"hi!"])") &&
+							   contains(web_view.evaluations(), R"([5,1,window.external.__bytes("YWJj")])");
+					}));
+			// the bytes of the worker are given to the implementation as they are
+			expect(web_view.binary_resolutions() == std::vector<WebViewMock::call_id_type>{5});
+		};
+
+		"destroyed while a call runs"_test = []
+		{
+			std::atomic<bool> started{false};
+			{
+				WebViewMock web_view{};
+				web_view.set_worker_pool({.threads = 1, .capacity = 4});
+				web_view.bind(
+						"sleep",
+						[&started](const WebViewMock::string_view_type) -> void
+						{
+							started = true;
+							std::this_thread::sleep_for(std::chrono::milliseconds{20});
+						},
+						Execution::POOL);
+				expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+				web_view.post_message(1, "sleep", "");
+				web_view.post_message(2, "sleep", "");
+				expect(web_view.iteration());
+				while (!started) { std::this_thread::yield(); }
+			}
+			// the running call completed, the waiting one was dropped
+			expect(started.load());
+		};
+	};
+
+	// std::pmr strings and callbacks which never allocate
+	struct InplaceTraits
+	{
+		using string_type    = std::pmr::string;
+		using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+		template<typename Signature>
+		using function_type = gal::web_view::impl::InplaceFunction<Signature, 64>;
+	};
+
+	using InplaceMock = gal::web_view::impl::BasicWebViewMock<InplaceTraits>;
+
+	class CountingResource final : public std::pmr::memory_resource
+	{
+	public:
+		std::size_t allocations{0};
+
+	private:
+		auto do_allocate(const std::size_t bytes, const std::size_t alignment) -> void* override
+		{
+			++allocations;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+
+		auto do_deallocate(void* p, const std::size_t bytes, const std::size_t alignment) -> void override { std::pmr::new_delete_resource()->deallocate(p, bytes, alignment); }
+
+		[[nodiscard]] auto do_is_equal(const memory_resource& other) const noexcept -> bool override { return this == &other; }
+	};
+
+	suite test_mock_policy = []
+	{
+		"pmr strings and inplace callbacks"_test = []
+		{
+			CountingResource resource{};
+			InplaceMock      web_view{
+					InplaceMock::default_window_width,
+					InplaceMock::default_window_height,
+					{},
+					false,
+					false,
+					false,
+					InplaceMock::string_type{InplaceMock::default_index_url},
+					&resource};
+			expect(web_view.get_allocator().resource() == &resource);
+
+			bool from_resource = false;
+			web_view.bind(
+					"owned",
+					[&from_resource, &resource](InplaceMock&, InplaceMock::string_type&& message) -> void { from_resource = message.get_allocator().resource() == &resource; });
+			web_view.bind(
+					"echo",
+					[](InplaceMock& wv, const InplaceMock::call_id_type id, const InplaceMock::string_view_type arg) -> void { wv.resolve(id, arg); });
+			web_view.bind<&add>("add");
+
+			int navigations = 0;
+			web_view.on_navigation([&navigations](InplaceMock&, NavigationEvent, const InplaceMock::navigation_type&) -> void { ++navigations; });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			const auto before = resource.allocations;
+			web_view.post_message(1, "owned", "a message which does not fit in the small buffer");
+			web_view.post_message(2, "echo", "hello");
+			web_view.post_message(3, "add", "[1,2]");
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://example.com/");
+			web_view.dispatch([](InplaceMock& wv) -> void { wv.set_window_title(std::string_view{"dispatched"}); });
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(from_resource);
+			expect(resource.allocations > before) << "the copy of the message comes from the resource of the web view";
+			expect(contains(web_view.evaluations(), R"([2,1,"hello"])"));
+			expect(contains(web_view.evaluations(), "[3,1,3]"));
+			expect(navigations == 1_i);
+			expect(web_view.current_navigation().url.get_allocator().resource() == &resource);
+			expect(web_view.window_title() == "dispatched");
+		};
+	};
+
+	// where the last words were decoded
+	const std::pmr::memory_resource* words_resource = nullptr;
+
+	[[nodiscard]] auto count_words(const std::pmr::vector<std::pmr::string>& words) -> std::size_t
+	{
+		words_resource = words.empty() ? nullptr : words.back().get_allocator().resource();
+		return words.size();
+	}
+
+	suite test_mock_arena = []
+	{
+		using gal::web_view::ArenaReset;
+
+		"per message"_test = []
+		{
+			WebViewMock web_view{};
+
+			std::vector<const void*> blocks{};
+			bool                     same_resource = true;
+			web_view.bind(
+					"copy",
+					[&blocks, &same_resource](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type arg, std::pmr::memory_resource& resource) -> void
+					{
+						same_resource = same_resource && &resource == &wv.message_resource();
+						const std::pmr::string copy{arg, &resource};
+						blocks.push_back(copy.data());
+						wv.resolve(id, copy);
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "copy", "a message which does not fit in the small buffer");
+			web_view.post_message(2, "copy", "another message which does not fit in the small buffer");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(same_resource);
+			expect(blocks.size() == 2_ul);
+			expect(blocks[0] == blocks[1]) << "released after every message";
+			expect(contains(web_view.evaluations(), R"([2,1,"another message which does not fit in the small buffer"])"));
+		};
+
+		"per iteration"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_message_arena({.size = 1024, .reset = ArenaReset::PER_ITERATION});
+			expect(web_view.message_arena().size == 1024_ul);
+
+			std::vector<const void*> blocks{};
+			web_view.bind(
+					"copy",
+					[&blocks](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::bytes_view_type bytes, std::pmr::memory_resource& resource) -> void
+					{
+						const std::pmr::vector<std::byte> copy{bytes.begin(), bytes.end(), &resource};
+						blocks.push_back(copy.data());
+						wv.resolve(id, copy.size());
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			const std::vector<std::byte> bytes(100, std::byte{42});
+			web_view.post_binary_message(1, "copy", bytes);
+			web_view.post_binary_message(2, "copy", bytes);
+			expect(web_view.iteration());
+			web_view.post_binary_message(3, "copy", bytes);
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+
+			expect(blocks.size() == 3_ul);
+			expect(blocks[0] != blocks[1]) << "the messages of one iteration share the arena";
+			expect(blocks[0] == blocks[2]) << "released by the next iteration";
+			expect(contains(web_view.evaluations(), "[3,1,100]"));
+		};
+
+		"larger than the arena"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_message_arena({.size = 64, .reset = ArenaReset::PER_MESSAGE});
+			web_view.bind(
+					"size",
+					[](WebViewMock& wv, const WebViewMock::call_id_type id, const WebViewMock::string_view_type arg, std::pmr::memory_resource& resource) -> void
+					{
+						std::pmr::string copy{&resource};
+						for (int i = 0; i < 100; ++i) { copy.append(arg); }
+						wv.resolve(id, copy.size());
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "size", "0123456789");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+			expect(contains(web_view.evaluations(), "[1,1,1000]"));
+		};
+
+		"typed arguments"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind<&count_words>("count");
+			web_view.bind<&count_words>("count_on_workers", Execution::POOL);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "count", R"([["a","b","a word which does not fit in the small buffer"]])");
+			expect(web_view.iteration());
+			expect(web_view.iteration());
+			expect(contains(web_view.evaluations(), "[1,1,3]"));
+			expect(words_resource == &web_view.message_resource()) << "decoded into the arena";
+
+			web_view.post_message(2, "count_on_workers", R"([["a word which does not fit in the small buffer"]])");
+			expect(wait_until(web_view, [&web_view] { return contains(web_view.evaluations(), "[2,1,1]"); }));
+			expect(words_resource == std::pmr::get_default_resource()) << "not the arena on a worker";
+		};
+	};
+
+	suite test_mock_navigation_events = []
+	{
+		using events_type = std::vector<std::pair<NavigationEvent, WebViewMock::navigation_type>>;
+
+		"lifecycle"_test = []
+		{
+			WebViewMock web_view{};
+			// the Navigation Timing script
+			web_view.set_eval_handler(
+					[](WebViewMock&, const WebViewMock::string_view_type code) -> WebViewMock::eval_result_type
+					{
+						if (code.find("performance.getEntriesByType('navigation')") == WebViewMock::string_view_type::npos) { return {EvalResult::EVAL_FAILED, "unexpected"}; }
+						return {EvalResult::SUCCESS, "[0,0,1.5,2,3,3,4,4.5,10,12,20,25,30,31.25,1024,4096]"};
+					});
+
+			events_type events{};
+			web_view.on_navigation([&events](WebViewMock&, const NavigationEvent event, const WebViewMock::navigation_type& navigation) -> void { events.emplace_back(event, navigation); });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			expect(web_view.current_navigation().id == 0u);
+
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "http://example.com");
+			web_view.simulate_navigation_event(NavigationEvent::REDIRECTED, "https://example.com");
+			web_view.simulate_navigation_event(NavigationEvent::COMMITTED, "https://example.com/");
+			web_view.simulate_navigation_event(NavigationEvent::FINISHED, "https://example.com/");
+			expect(web_view.iteration());
+			// the timing script
+			expect(web_view.iteration());
+
+			expect(events.size() == 5_ul);
+			expect(events[0].first == NavigationEvent::STARTED);
+			expect(events[1].first == NavigationEvent::REDIRECTED);
+			expect(events[2].first == NavigationEvent::COMMITTED);
+			expect(events[3].first == NavigationEvent::FINISHED);
+			expect(events[4].first == NavigationEvent::TIMING);
+
+			const auto& navigation = web_view.current_navigation();
+			expect(navigation.id == 1u);
+			expect(navigation.url == "https://example.com/");
+			expect(!navigation.failed());
+			expect(navigation.started <= navigation.redirected);
+			expect(navigation.redirected <= navigation.committed);
+			expect(navigation.committed <= navigation.finished);
+			expect(navigation.started != WebViewMock::navigation_clock_type::time_point{});
+
+			expect(navigation.timing.has_value());
+			expect(navigation.timing->response_start == 10.0);
+			expect(navigation.timing->load_event_end == 31.25);
+			expect(navigation.timing->decoded_body_size == 4096.0);
+			expect(!events[3].second.timing.has_value()) << "the timing comes later";
+		};
+
+		"failed"_test = []
+		{
+			WebViewMock web_view{};
+			events_type events{};
+			web_view.on_navigation([&events](WebViewMock&, const NavigationEvent event, const WebViewMock::navigation_type& navigation) -> void { events.emplace_back(event, navigation); });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.clear_records();
+
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://unreachable.example");
+			web_view.simulate_navigation_event(NavigationEvent::FAILED, "https://unreachable.example", "Could not resolve host");
+			web_view.simulate_navigation_event(NavigationEvent::FINISHED, "https://unreachable.example");
+			expect(web_view.iteration());
+
+			expect(events.size() == 2_ul) << "FINISHED after FAILED is not reported";
+			expect(events.back().first == NavigationEvent::FAILED);
+			expect(web_view.current_navigation().failed());
+			expect(web_view.current_navigation().error == "Could not resolve host");
+			expect(web_view.evaluations().empty()) << "no timing for a failed navigation";
+
+			// the next one starts from scratch
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://example.com");
+			expect(web_view.iteration());
+			expect(web_view.current_navigation().id == 2u);
+			expect(!web_view.current_navigation().failed());
+			expect(web_view.current_navigation().finished == WebViewMock::navigation_clock_type::time_point{});
+		};
+
+		"stale timing"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_eval_handler([](WebViewMock&, WebViewMock::string_view_type) -> WebViewMock::eval_result_type { return {EvalResult::SUCCESS, "[0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]"}; });
+
+			events_type events{};
+			web_view.on_navigation([&events](WebViewMock&, const NavigationEvent event, const WebViewMock::navigation_type& navigation) -> void { events.emplace_back(event, navigation); });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.set_latency(std::chrono::milliseconds{20});
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "a:");
+			web_view.simulate_navigation_event(NavigationEvent::FINISHED, "a:");
+			expect(web_view.iteration());
+			// another navigation starts before the timing arrives
+			web_view.set_latency({});
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "b:");
+			expect(web_view.iteration());
+			expect(web_view.current_navigation().id == 2u);
+			expect(web_view.iteration());
+			expect(web_view.pending_events() == 0_ul);
+
+			expect(std::ranges::none_of(events, [](const auto& pair) { return pair.first == NavigationEvent::TIMING; }));
+		};
+
+		"destroyed before the timing"_test = []
+		{
+			events_type events{};
+			{
+				auto web_view = std::make_unique<WebViewMock>();
+				web_view->set_eval_handler([](WebViewMock&, WebViewMock::string_view_type) -> WebViewMock::eval_result_type { return {EvalResult::SUCCESS, "[0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]"}; });
+				web_view->on_navigation([&events](WebViewMock&, const NavigationEvent event, const WebViewMock::navigation_type& navigation) -> void { events.emplace_back(event, navigation); });
+				expect(web_view->service_start() == ServiceStartResult::SUCCESS);
+
+				web_view->simulate_navigation_event(NavigationEvent::STARTED, "a:");
+				web_view->simulate_navigation_event(NavigationEvent::FINISHED, "a:");
+				// the engine keeps the script of the timing
+				web_view->set_latency(std::chrono::hours{1});
+				expect(web_view->iteration());
+				expect(web_view->pending_events() == 1_ul);
+			}
+
+			expect(!events.empty() && events.back().first == NavigationEvent::FINISHED);
+		};
+	};
+
+	// Runs the loop until the predicate holds (at most `max` iterations).
+	template<typename Predicate>
+	auto iterate_until(WebViewMock& web_view, Predicate predicate, const int max = 10) -> bool
+	{
+		for (int i = 0; i < max && !predicate(); ++i) { (void)web_view.iteration(); }
+		return predicate();
+	}
+
+	[[nodiscard]] auto add_later(WebViewMock& web_view, const int a, std::string b) -> Task<std::string>
+	{
+		// echo
+		const auto result = co_await web_view.eval_async("40");
+		co_return std::to_string(a + std::stoi(result.value)) + b;
+	}
+
+	auto eval_in_order(WebViewMock& web_view, std::vector<std::string>& results) -> Task<>
+	{
+		for (const auto* code: {"1", "2", "3"})
+		{
+			auto result = co_await web_view.eval_async(code);
+			results.push_back(std::move(result.value));
+		}
+	}
+
+	auto load_title(WebViewMock& web_view, std::optional<WebViewMock::navigation_type>& navigation, std::string& title) -> Task<>
+	{
+		navigation = co_await web_view.navigate_async("https://example.com/");
+		title      = (co_await web_view.eval_async("document.title")).value;
+	}
+
+	suite test_mock_coroutine = []
+	{
+		using gal::web_view::impl::spawn;
+
+		"co_await eval"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			std::vector<std::string> results{};
+			spawn(eval_in_order(web_view, results));
+			expect(results.empty()) << "nothing is evaluated before the loop runs";
+
+			expect(iterate_until(web_view, [&results] { return results.size() == 3; }));
+			expect(results == std::vector<std::string>{"1", "2", "3"});
+		};
+
+		"co_await navigate"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			std::optional<WebViewMock::navigation_type> navigation{};
+			std::string                                 title{};
+			spawn(load_title(web_view, navigation, title));
+			expect(web_view.navigations().back() == "https://example.com/");
+
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://example.com/");
+			web_view.simulate_navigation_event(NavigationEvent::COMMITTED, "https://example.com/");
+			expect(web_view.iteration());
+			expect(!navigation.has_value()) << "not before the load finished";
+
+			web_view.simulate_navigation_event(NavigationEvent::FINISHED, "https://example.com/");
+			expect(web_view.iteration());
+			expect(navigation.has_value());
+			expect(navigation->url == "https://example.com/");
+			expect(!navigation->failed());
+
+			expect(iterate_until(web_view, [&title] { return !title.empty(); }));
+			expect(title == "document.title");
+		};
+
+		"navigation in progress"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://old.example/");
+			expect(web_view.iteration());
+
+			std::optional<WebViewMock::navigation_type> navigation{};
+			std::string                                 title{};
+			spawn(load_title(web_view, navigation, title));
+
+			// the old one is cancelled
+			web_view.simulate_navigation_event(NavigationEvent::FAILED, "https://old.example/", "cancelled");
+			expect(web_view.iteration());
+			expect(!navigation.has_value());
+
+			web_view.simulate_navigation_event(NavigationEvent::STARTED, "https://example.com/");
+			web_view.simulate_navigation_event(NavigationEvent::FAILED, "https://example.com/", "Could not resolve host");
+			expect(web_view.iteration());
+			expect(navigation.has_value());
+			expect(navigation->error == "Could not resolve host");
+
+			// let it complete
+			expect(iterate_until(web_view, [&title] { return !title.empty(); }));
+		};
+
+		"task handler"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind(
+					"shout",
+					[](WebViewMock& wv, std::string text) -> Task<std::string>
+					{
+						co_await wv.eval_async("wait");
+						co_return text + "!";
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "shout", "hi");
+			expect(web_view.iteration());
+			expect(!contains(web_view.evaluations(), R"([1,1,"hi!"])")) << "the handler is suspended";
+
+			// the task keeps the handler alive
+			expect(web_view.unbind("shout"));
+			expect(iterate_until(web_view, [&web_view] { return contains(web_view.evaluations(), R"([1,1,"hi!"])"); }));
+		};
+
+		"typed coroutine"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.bind<&add_later>("add_later");
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			web_view.post_message(1, "add_later", R"([2,"x"])");
+			web_view.post_message(2, "add_later", "[2]");
+			expect(iterate_until(web_view, [&web_view] { return contains(web_view.evaluations(), R"([1,1,"42x"])"); }));
+			expect(contains(web_view.evaluations(), R"([2,0,"invalid arguments"])"));
+		};
+	};
+
+	suite test_mock_loop = []
+	{
+		using namespace std::chrono_literals;
+
+		"poll does not block"_test = []
+		{
+			WebViewMock web_view{};
+			web_view.set_latency(50ms);
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			auto future = web_view.eval_async("1");
+
+			const auto begin = WebViewMock::clock_type::now();
+			expect(web_view.poll());
+			expect(WebViewMock::clock_type::now() - begin < 50ms);
+			expect(!future.ready());
+
+			expect(web_view.iteration(100ms));
+			expect(future.ready());
+		};
+
+		"iteration timeout"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.clear_records();
+
+			const auto begin = WebViewMock::clock_type::now();
+			expect(web_view.iteration(10ms));
+			expect(WebViewMock::clock_type::now() - begin >= 10ms);
+		};
+
+		"poll drains every ready event"_test = []
+		{
+			WebViewMock web_view{};
+			int         calls = 0;
+			web_view.bind("ping", [&calls](WebViewMock&, const WebViewMock::string_view_type) -> void { ++calls; });
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			for (WebViewMock::call_id_type id = 1; id <= 10; ++id) { web_view.post_message(id, "ping", ""); }
+			expect(web_view.poll());
+			expect(calls == 10_i);
+			expect(web_view.pending_events() == 0_ul);
+		};
+
+		"run until shutdown"_test = []
+		{
+			WebViewMock web_view{};
+			int         calls = 0;
+			web_view.bind(
+					"ping",
+					[&calls](WebViewMock& wv, const WebViewMock::string_view_type) -> void
+					{
+						if (++calls == 3) { wv.shutdown(); }
+					});
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+
+			for (WebViewMock::call_id_type id = 1; id <= 5; ++id) { web_view.post_message(id, "ping", ""); }
+			web_view.run();
+			expect(calls == 3_i);
+			expect(web_view.service_state() == ServiceStateResult::SHUTDOWN);
+		};
+	};
+
+	suite test_mock_shutdown = []
+	{
+		"shutdown"_test = []
+		{
+			WebViewMock web_view{};
+			expect(web_view.service_start() == ServiceStartResult::SUCCESS);
+			web_view.bind("quit", [](WebViewMock& wv, const WebViewMock::string_view_type) -> void { wv.shutdown(); });
+
+			web_view.post_message(1, "quit", "");
+			expect(!web_view.iteration());
+			expect(web_view.service_state() == ServiceStateResult::SHUTDOWN);
+		};
+	};
+}// namespace